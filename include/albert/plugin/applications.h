@@ -5,6 +5,8 @@
 #include <QUrl>
 #include <albert/export.h>
 #include <albert/extension.h>
+#include <memory>
+#include <vector>
 class QWidget;
 
 namespace applications {
@@ -26,6 +28,8 @@ public:
     virtual QString path() const = 0;
 
     /// Launch the application
+    ///
+    /// Thread-safe. Launches requested from other threads are queued to the main thread.
     virtual void launch() const = 0;
 
     // /// The supported URL schemes
@@ -51,10 +55,95 @@ protected:
 };
 
 
+/// An immutable generation of the indexed applications.
+///
+/// Snapshots are never modified once published, hence the lookups can be used from any
+/// thread. Holding a snapshot keeps its applications alive. See Application::launch() for
+/// launching from other threads.
+class ALBERT_EXPORT Snapshot
+{
+public:
+
+    /// The generation number, increasing with every reindex
+    /// \returns \copybrief
+    virtual quint64 generation() const = 0;
+
+    /// The applications of this generation
+    /// \returns \copybrief
+    virtual const std::vector<std::shared_ptr<Application>> &applications() const = 0;
+
+    /// The application with the unique id _id_
+    /// \returns \copybrief or nullptr
+    virtual std::shared_ptr<Application> byId(const QString &id) const = 0;
+
+    /// The applications having an executable with the file name _name_
+    /// \returns \copybrief
+    virtual std::vector<std::shared_ptr<Application>> byExecutable(const QString &name) const = 0;
+
+    /// The application with the spec, bundle or such at _path_
+    /// \returns \copybrief or nullptr
+    virtual std::shared_ptr<Application> byPath(const QString &path) const = 0;
+
+    /// The application owning windows of class _window_class_
+    ///
+    /// Matches the X11 WM_CLASS or the Wayland app-id case-insensitively against, in this
+    /// order of precedence, the StartupWMClass, the id, the flatpak app-id, the last
+    /// component of reverse DNS ids (e.g. 'Nautilus' of 'org.gnome.Nautilus') and the
+    /// executable name, unwrapped from env, sh -c, flatpak and snap launchers, of the
+    /// applications. On macOS the bundle identifier and the executable name are matched.
+    /// \returns \copybrief or nullptr
+    virtual std::shared_ptr<Application> byWindowClass(const QString &window_class) const = 0;
+
+    /// The categories of the applications of this generation, e.g. the XDG main and
+    /// additional categories
+    /// \returns \copybrief
+    virtual QStringList categories() const = 0;
+
+    /// The applications in the category _category_
+    /// \returns \copybrief
+    virtual std::vector<std::shared_ptr<Application>> byCategory(const QString &category) const = 0;
+
+protected:
+
+    virtual ~Snapshot() = default;
+
+};
+
+
+/// Observer of the applications index
+class ALBERT_EXPORT Observer
+{
+public:
+
+    /// Called in the main thread when the snapshot of generation _generation_ has been
+    /// published. Cached handles of older generations should be refreshed.
+    virtual void applicationsChanged(quint64 generation) = 0;
+
+protected:
+
+    virtual ~Observer() = default;
+
+};
+
+
 class ALBERT_EXPORT Plugin : virtual public albert::Extension
 {
 public:
 
+    /// The snapshot of the current generation
+    ///
+    /// Thread-safe without plugin-level locking, the snapshot is an atomic shared pointer.
+    /// Note that the standard library may implement the latter using an internal lock.
+    /// Initially empty, until the first index run finished.
+    /// \returns \copybrief
+    virtual std::shared_ptr<const Snapshot> snapshot() const = 0;
+
+    /// Registers _observer_ to be notified about new generations. Main thread only.
+    virtual void addObserver(Observer *observer) = 0;
+
+    /// Unregisters _observer_. Main thread only.
+    virtual void removeObserver(Observer *observer) = 0;
+
     /// Launch a shell script in the users terminal and shell
     ///
     /// To keep the terminal open use `exec $SHELL`
@@ -1,11 +1,27 @@
 // Copyright (c) 2022-2025 Manuel Schneider
 
 #include "applicationbase.h"
+#include "memoryreport.h"
 using namespace std;
 using namespace albert;
 
+QString ApplicationBase::launch_text_;
+
+void ApplicationBase::retranslate() { launch_text_ = tr("Launch application"); }
+
 const QStringList &ApplicationBase::names() const { return names_; }
 
+bool ApplicationBase::equals(const ApplicationBase &o) const
+{ return id_ == o.id_ && path_ == o.path_ && names_ == o.names_; }
+
+void ApplicationBase::accountMemory(MemoryReport &r) const
+{
+    r.add(MemoryReport::Objects, sizeof(ApplicationBase));
+    r.addString(id_);
+    r.addString(path_);
+    r.addStringList(names_);
+}
+
 QString ApplicationBase::path() const { return path_; }
 
 QString ApplicationBase::id() const { return id_; }
@@ -19,6 +35,6 @@ QString ApplicationBase::inputActionText() const { return name(); }
 vector<Action> ApplicationBase::actions() const
 {
     vector<Action> actions;
-    actions.emplace_back(QStringLiteral("launch"), tr("Launch application"), [this]{ launch(); });
+    actions.emplace_back(QStringLiteral("launch"), launch_text_, [this]{ launch(); });
     return actions;
 }
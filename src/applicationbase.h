@@ -6,6 +6,7 @@
 #include <QStringList>
 #include <albert/item.h>
 #include <vector>
+class MemoryReport;
 
 class ApplicationBase : public applications::Application, public albert::Item
 {
@@ -22,8 +23,21 @@ public:
 
     const QStringList &names() const;
 
+    /// Returns true if _other_ has the same content.
+    /// Overrides compare their own members and call the base implementation.
+    virtual bool equals(const ApplicationBase &other) const;
+
+    /// Adds the memory of this application to _report_.
+    /// Overrides add their own members and call the base implementation.
+    virtual void accountMemory(MemoryReport &report) const;
+
+    /// Updates the cached translations of the action texts.
+    static void retranslate();
+
 protected:
 
+    static QString launch_text_;
+
     QString id_;
     QStringList names_;
     QString path_;
@@ -0,0 +1,134 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "generation.h"
+#include <bit>
+using namespace std;
+using applications::Application;
+
+Generation::Generation(quint64 generation,
+                       vector<shared_ptr<Application>> applications,
+                       const Keys &keys):
+    generation_(generation),
+    applications_(::move(applications))
+{
+    by_id_.reserve(applications_.size());
+    by_path_.reserve(applications_.size());
+    by_executable_.reserve(applications_.size());
+    by_pointer_.reserve(applications_.size());
+
+    const auto words = (applications_.size() + 63) / 64;
+
+    for (uint i = 0; i < applications_.size(); ++i)
+    {
+        const auto &app = *applications_[i];
+        by_id_.insert(app.id(), i);
+        by_path_.insert(app.path(), i);
+        by_pointer_.insert(&app, i);
+        if (const auto name = keys.executable_name(app); !name.isEmpty())
+            by_executable_.insert(name, i);
+
+        for (const auto &category : keys.categories(app))
+        {
+            auto &bits = by_category_[category.toCaseFolded()];
+            if (bits.empty())
+            {
+                bits.resize(words);
+                categories_ << category;
+            }
+            bits[i / 64] |= quint64(1) << (i % 64);
+        }
+    }
+
+    vector<QStringList> classes;
+    classes.reserve(applications_.size());
+    qsizetype tiers = 0;
+    for (const auto &app : applications_)
+    {
+        classes.emplace_back(keys.window_classes(*app));
+        tiers = max(tiers, classes.back().size());
+    }
+
+    // Tier by tier, such that e.g. a StartupWMClass is not shadowed by the id of another app
+    by_window_class_.reserve(applications_.size() * tiers);
+    for (qsizetype tier = 0; tier < tiers; ++tier)
+        for (uint i = 0; i < classes.size(); ++i)
+            if (tier < classes[i].size() && !classes[i][tier].isEmpty())
+                if (auto key = classes[i][tier].toCaseFolded(); !by_window_class_.contains(key))
+                    by_window_class_.insert(key, i);
+}
+
+quint64 Generation::generation() const { return generation_; }
+
+const vector<shared_ptr<Application>> &Generation::applications() const { return applications_; }
+
+shared_ptr<Application> Generation::byId(const QString &id) const
+{
+    if (auto it = by_id_.constFind(id); it != by_id_.cend())
+        return applications_[*it];
+    return {};
+}
+
+vector<shared_ptr<Application>> Generation::byExecutable(const QString &name) const
+{
+    vector<shared_ptr<Application>> r;
+    for (auto [it, end] = by_executable_.equal_range(name); it != end; ++it)
+        r.emplace_back(applications_[*it]);
+    return r;
+}
+
+shared_ptr<Application> Generation::byPath(const QString &path) const
+{
+    if (auto it = by_path_.constFind(path); it != by_path_.cend())
+        return applications_[*it];
+    return {};
+}
+
+shared_ptr<Application> Generation::byWindowClass(const QString &window_class) const
+{
+    if (auto it = by_window_class_.constFind(window_class.toCaseFolded());
+        it != by_window_class_.cend())
+        return applications_[*it];
+    return {};
+}
+
+QStringList Generation::categories() const { return categories_; }
+
+vector<shared_ptr<Application>> Generation::byCategory(const QString &category) const
+{
+    if (auto it = by_category_.constFind(category.toCaseFolded()); it != by_category_.cend())
+        return select(*it);
+    return {};
+}
+
+Generation::Bitset Generation::categoryBits(const QStringList &categories) const
+{
+    Bitset bits((applications_.size() + 63) / 64, ~quint64(0));
+    if (const auto tail = applications_.size() % 64)
+        bits.back() = (quint64(1) << tail) - 1;  // No bits past the end
+    for (const auto &category : categories)
+        if (auto it = by_category_.constFind(category.toCaseFolded()); it == by_category_.cend())
+            return Bitset(bits.size(), 0);
+        else
+            for (size_t w = 0; w < bits.size(); ++w)
+                bits[w] &= (*it)[w];
+    return bits;
+}
+
+vector<shared_ptr<Application>> Generation::select(const Bitset &bits) const
+{
+    vector<shared_ptr<Application>> r;
+    for (uint w = 0; w < bits.size(); ++w)
+        for (auto word = bits[w]; word; word &= word - 1)  // Clears the lowest bit
+            r.emplace_back(applications_[w * 64 + countr_zero(word)]);
+    return r;
+}
+
+optional<uint> Generation::indexOf(const Application *app) const
+{
+    if (auto it = by_pointer_.constFind(app); it != by_pointer_.cend())
+        return *it;
+    return {};
+}
+
+bool Generation::test(const Bitset &bits, uint index)
+{ return index / 64 < bits.size() && bits[index / 64] >> (index % 64) & 1; }
@@ -0,0 +1,77 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include "applications.h"
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+///
+/// Immutable snapshot of an index generation with hashed lookups.
+///
+class Generation final : public applications::Snapshot
+{
+public:
+
+    /// Platform specific keys of an application.
+    struct Keys
+    {
+        /// Returns the file name of the executable or an empty string if unknown.
+        std::function<QString(const applications::Application &)> executable_name;
+
+        /// Returns the window classes in order of precedence, empty strings for unknown
+        /// ones. Classes of higher precedence win over those of other applications.
+        std::function<QStringList(const applications::Application &)> window_classes;
+
+        /// Returns the categories.
+        std::function<QStringList(const applications::Application &)> categories;
+    };
+
+    /// Set of applications, a bit per index into applications().
+    using Bitset = std::vector<quint64>;
+
+    /// Builds the lookup tables of _applications_ using _keys_.
+    Generation(quint64 generation,
+               std::vector<std::shared_ptr<applications::Application>> applications,
+               const Keys &keys);
+
+    quint64 generation() const override;
+    const std::vector<std::shared_ptr<applications::Application>> &applications() const override;
+    std::shared_ptr<applications::Application> byId(const QString &id) const override;
+    std::vector<std::shared_ptr<applications::Application>>
+    byExecutable(const QString &name) const override;
+    std::shared_ptr<applications::Application> byPath(const QString &path) const override;
+    std::shared_ptr<applications::Application>
+    byWindowClass(const QString &window_class) const override;
+    QStringList categories() const override;
+    std::vector<std::shared_ptr<applications::Application>>
+    byCategory(const QString &category) const override;
+
+    /// Returns the applications having all of _categories_. Case insensitive.
+    Bitset categoryBits(const QStringList &categories) const;
+
+    /// Returns the applications in _bits_.
+    std::vector<std::shared_ptr<applications::Application>> select(const Bitset &bits) const;
+
+    /// Returns the index of _app_ in applications().
+    std::optional<uint> indexOf(const applications::Application *app) const;
+
+    static bool test(const Bitset &bits, uint index);
+
+private:
+
+    const quint64 generation_;
+    const std::vector<std::shared_ptr<applications::Application>> applications_;
+    QHash<QString, uint> by_id_;  // Indices into applications_
+    QHash<QString, uint> by_path_;
+    QMultiHash<QString, uint> by_executable_;
+    QHash<QString, uint> by_window_class_;  // Case folded
+    QHash<const applications::Application*, uint> by_pointer_;
+    QHash<QString, Bitset> by_category_;  // Case folded
+    QStringList categories_;  // As spelled by the first application
+
+};
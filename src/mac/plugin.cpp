@@ -5,6 +5,7 @@
 #include "ui_configwidget.h"
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QSettings>
 #include <QWidget>
 #include <albert/app.h>
@@ -30,15 +31,15 @@ static QStringList appDirectories()
 }
 }
 
-static void scanRecurse(QStringList &result, const QString &path, const bool abort = false)
+static void scanRecurse(QStringList &result, const QString &path, const bool &abort)
 {
     for (const auto &fi : QDir(path).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
-        if (fi.isBundle())
-            result << fi.absoluteFilePath();
-        else if (abort)
+        if (abort)
             break;
+        else if (fi.isBundle())
+            result << fi.absoluteFilePath();
         else
-            scanRecurse(result, fi.absoluteFilePath());
+            scanRecurse(result, fi.absoluteFilePath(), abort);
 }
 
 Plugin::Plugin()
@@ -50,6 +51,7 @@ Plugin::Plugin()
 
     indexer.parallel = [this](const bool &abort)
     {
+        indexRunStarted();
         vector<shared_ptr<applications::Application>> apps;
 
         apps.emplace_back(make_shared<Application>(u"/System/Library/CoreServices/Finder.app"_s,
@@ -61,7 +63,7 @@ Plugin::Plugin()
 
         for (const auto &path : as_const(app_paths))
             if (abort)
-                return apps;
+                break;
             else
                 try {
                     apps.emplace_back(make_shared<Application>(path, use_non_localized_name_));
@@ -71,18 +73,54 @@ Plugin::Plugin()
 
         ranges::sort(apps, [](const auto &a, const auto &b){ return a->id() < b->id(); });
 
+        indexRunFinished(abort);
         return apps;
     };
 
     indexer.finish = [this]
     {
-        applications = indexer.takeResult();
-        INFO << u"Indexed %1 applications."_s.arg(applications.size());
-        setIndexItems(buildIndexItems());
-        emit appsChanged();
+        auto apps = indexer.takeResult();
+        if (index_run_aborted)
+        {
+            DEBG << "Discarding the result of an aborted index run.";
+            return;
+        }
+
+        const auto delta = replaceApplications(::move(apps));
+        if (delta.empty())
+        {
+            DEBG << u"Indexed %1 applications. No changes."_s.arg(applications.size());
+            return;
+        }
+        INFO << u"Indexed %1 applications. Added %2, removed %3, modified %4."_s
+                    .arg(applications.size())
+                    .arg(delta.added.size())
+                    .arg(delta.removed.size())
+                    .arg(delta.modified.size());
+        publishSnapshot();
+        publishIndexItems();
+        emit appsChanged(delta);
     };
 }
 
+QString Plugin::executableName(const applications::Application &app) const
+{
+    // The bundle executable is named like the bundle by convention
+    return QFileInfo(app.path()).completeBaseName();
+}
+
+QStringList Plugin::windowClasses(const applications::Application &app) const
+{
+    // Windows are identified by the bundle identifier of their application
+    return {app.id(), executableName(app)};
+}
+
+QStringList Plugin::categories(const applications::Application &) const
+{
+    // LSApplicationCategoryType is set by App Store apps only
+    return {};
+}
+
 QWidget *Plugin::buildConfigWidget()
 {
     auto *w = new QWidget;
@@ -12,4 +12,9 @@ public:
 
     QWidget *buildConfigWidget() override;
     void runTerminal(const QString &script) const override;
+
+protected:
+    QString executableName(const applications::Application &) const override;
+    QStringList windowClasses(const applications::Application &) const override;
+    QStringList categories(const applications::Application &) const override;
 };
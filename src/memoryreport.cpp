@@ -0,0 +1,83 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "memoryreport.h"
+#include <albert/item.h>
+#include <numeric>
+using namespace Qt::StringLiterals;
+using namespace albert;
+using namespace std;
+
+// Reference counts and vtable of the control block allocated by make_shared
+static constexpr size_t control_block_size = sizeof(void*) + 2 * sizeof(int);
+
+static const array<QString, MemoryReport::CategoryCount> category_names
+{
+    u"objects"_s,
+    u"strings"_s,
+    u"string_lists"_s,
+    u"actions"_s,
+    u"index_items"_s,
+    u"control_blocks"_s
+};
+
+MemoryReport MemoryReport::excluding(const MemoryReport &other)
+{
+    MemoryReport r;
+    r.seen_ = other.seen_;
+    return r;
+}
+
+void MemoryReport::add(Category c, quint64 bytes) { bytes_[c] += bytes; }
+
+void MemoryReport::addString(const QString &s, Category c)
+{
+    // Literals and null strings have no header, i.e. no heap allocation
+    if (auto *d = s.data_ptr().d_ptr(); d && seen_.insert(d).second)
+        bytes_[c] += sizeof(QArrayData) + (s.capacity() + 1) * sizeof(QChar);
+}
+
+void MemoryReport::addStringList(const QStringList &l, Category c)
+{
+    if (auto *d = l.data_ptr().d_ptr(); d && seen_.insert(d).second)
+        bytes_[c] += sizeof(QArrayData) + l.capacity() * sizeof(QString);
+
+    for (const auto &s : l)
+        addString(s, c);
+}
+
+void MemoryReport::addIndexItems(const vector<IndexItem> &items)
+{
+    bytes_[IndexItems] += items.capacity() * sizeof(IndexItem);
+    for (const auto &i : items)
+        addString(i.string, IndexItems);
+}
+
+bool MemoryReport::addControlBlock(const void *object)
+{
+    if (!seen_.insert(object).second)
+        return false;
+
+    bytes_[ControlBlocks] += control_block_size;
+    return true;
+}
+
+quint64 MemoryReport::bytes(Category c) const { return bytes_[c]; }
+
+quint64 MemoryReport::total() const { return accumulate(bytes_.begin(), bytes_.end(), 0ull); }
+
+QJsonObject MemoryReport::toJson() const
+{
+    QJsonObject o;
+    for (int c = 0; c < CategoryCount; ++c)
+        o.insert(category_names[c], qint64(bytes_[c]));
+    o.insert(u"total"_s, qint64(total()));
+    return o;
+}
+
+QString MemoryReport::toString() const
+{
+    QStringList l;
+    for (int c = 0; c < CategoryCount; ++c)
+        l << u"%1 %2 KiB"_s.arg(category_names[c]).arg(bytes_[c] / 1024.0, 0, 'f', 1);
+    return u"%1 KiB (%2)"_s.arg(total() / 1024.0, 0, 'f', 1).arg(l.join(u", "_s));
+}
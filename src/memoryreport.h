@@ -0,0 +1,56 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <albert/indexitem.h>
+#include <array>
+#include <unordered_set>
+#include <vector>
+
+///
+/// Estimated heap bytes of an index generation by category.
+///
+/// Implicitly shared data and shared objects are counted once, by the category that visits
+/// them first. Allocator overhead is not included.
+///
+class MemoryReport
+{
+public:
+
+    enum Category
+    {
+        Objects,  ///< The application objects themselves
+        Strings,
+        StringLists,  ///< List arrays and the strings they contain
+        Actions,  ///< Desktop action vectors and their strings
+        IndexItems,  ///< Index item vectors and their strings
+        ControlBlocks,  ///< shared_ptr control blocks
+        CategoryCount
+    };
+
+    /// Returns an empty report which skips the objects and data counted by _other_.
+    static MemoryReport excluding(const MemoryReport &other);
+
+    void add(Category, quint64 bytes);
+    void addString(const QString &, Category = Strings);
+    void addStringList(const QStringList &, Category = StringLists);
+    void addIndexItems(const std::vector<albert::IndexItem> &);
+
+    /// Counts the control block of the shared object at _object_.
+    /// Returns false if the object has been counted already.
+    bool addControlBlock(const void *object);
+
+    quint64 bytes(Category) const;
+    quint64 total() const;
+
+    QJsonObject toJson() const;
+    QString toString() const;
+
+private:
+
+    std::array<quint64, CategoryCount> bytes_{};
+    std::unordered_set<const void*> seen_;
+
+};
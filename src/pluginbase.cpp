@@ -1,13 +1,20 @@
 // Copyright (c) 2022-2026 Manuel Schneider
 
 #include "applicationbase.h"
+#include "generation.h"
 #include "pluginbase.h"
+#include "searchindex.h"
 #include <QCheckBox>
+#include <QCoreApplication>
+#include <QEvent>
 #include <QFormLayout>
 #include <QSettings>
 #include <albert/indexitem.h>
 #include <albert/logging.h>
+#include <albert/query.h>
 #include <albert/widgetsutil.h>
+#include <algorithm>
+#include <chrono>
 ALBERT_LOGGING_CATEGORY("apps")
 using namespace Qt::StringLiterals;
 using namespace albert;
@@ -16,16 +23,175 @@ using namespace std;
 static const auto ck_use_non_localized_name = "use_non_localized_name";
 static const auto ck_split_camel_case = "split_camel_case";
 static const auto ck_use_acronyms = "use_acronyms";
+static const auto ck_typo_tolerant_search = "typo_tolerant_search";
+static const auto sk_launch_counts = "launch_counts";
+
+bool PluginBase::Delta::empty() const
+{ return added.isEmpty() && removed.isEmpty() && modified.isEmpty(); }
 
 QString PluginBase::defaultTrigger() const { return u"apps "_s; }
 
-void PluginBase::updateIndexItems()  { indexer.run(); }
+static qint64 steadyNow()
+{
+    using namespace chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void PluginBase::updateIndexItems()
+{
+    // The executor aborts a run in flight and restarts once it returned
+    if (qint64 expected = 0; index_running)
+        restart_requested.compare_exchange_strong(expected, steadyNow());
+    indexer.run();
+}
+
+void PluginBase::indexRunStarted()
+{
+    index_running = true;
+    if (const auto requested = restart_requested.exchange(0))
+    {
+        const auto ns = steadyNow() - requested;
+        ++index_restarts;
+        restart_ns += ns;
+        DEBG << u"Index run restarted after %1 ms."_s.arg(ns / 1'000'000.0, 0, 'f', 1);
+    }
+}
+
+void PluginBase::indexRunFinished(bool aborted)
+{
+    index_run_aborted = aborted;
+    if (aborted)
+        ++index_runs_aborted;
+    index_running = false;
+}
+
+// Splits the leading category facets off _string_, e.g. 'cat:Development cat:IDE code'
+static QStringList takeCategoryFacets(QString &string)
+{
+    QStringList categories;
+    string = string.trimmed();
+    while (string.startsWith(u"cat:"_s, Qt::CaseInsensitive))
+    {
+        const auto end = string.indexOf(QChar::Space);
+        categories << string.mid(4, end < 0 ? -1 : end - 4);  // size of 'cat:'
+        string = end < 0 ? QString() : string.mid(end).trimmed();
+    }
+    return categories;
+}
+
+vector<RankItem> PluginBase::handleGlobalQuery(const Query &query)
+{
+    shared_ptr<const SearchIndex> index;
+    {
+        lock_guard lock(search_index_mutex);
+        index = search_index;
+    }
+
+    vector<RankItem> r;
+    auto string = query.string();
+    if (const auto categories = takeCategoryFacets(string); !categories.isEmpty())
+        r = handleCategoryQuery(categories, string, index.get());
+    else if (index)
+        r = index->search(query.string());
+    else
+        r = IndexQueryHandler::handleGlobalQuery(query);
+
+    if (auto it = ranges::max_element(r, {}, &RankItem::score); it != r.end())
+        topRankedItem(*it->item);
+
+    return r;
+}
+
+void PluginBase::topRankedItem(const Item &) {}
+
+vector<RankItem> PluginBase::handleCategoryQuery(const QStringList &categories,
+                                                 const QString &string,
+                                                 const SearchIndex *index) const
+{
+    const auto generation = static_pointer_cast<const Generation>(snapshot());
+    const auto bits = generation->categoryBits(categories);
+
+    vector<RankItem> r;
+    if (index && !string.isEmpty())
+    {
+        for (auto &rank_item : index->search(string))
+            if (auto i = generation->indexOf(dynamic_cast<ApplicationBase*>(rank_item.item.get()));
+                i && Generation::test(bits, *i))
+                r.emplace_back(::move(rank_item));
+    }
+    else
+    {
+        for (const auto &iapp : generation->select(bits))
+        {
+            if (!isIndexed(*iapp))
+                continue;
+
+            auto app = static_pointer_cast<ApplicationBase>(iapp);
+            float score = string.isEmpty() ? 1.0f : 0.0f;
+            for (const auto &name : app->names())
+                if (name.startsWith(string, Qt::CaseInsensitive)
+                    || name.contains(u' ' + string, Qt::CaseInsensitive))
+                    score = max(score, (float)string.size() / name.size());
+            if (score > 0)
+                r.emplace_back(app, score);
+        }
+    }
+    return r;
+}
+
+shared_ptr<const applications::Snapshot> PluginBase::snapshot() const
+{ return current_snapshot.load(memory_order_acquire); }
+
+void PluginBase::addObserver(applications::Observer *o)
+{
+    if (ranges::find(observers, o) == observers.end())
+        observers.emplace_back(o);
+}
+
+void PluginBase::removeObserver(applications::Observer *o) { erase(observers, o); }
+
+void PluginBase::publishSnapshot()
+{
+    Generation::Keys keys{
+        .executable_name = [this](const auto &app){ return executableName(app); },
+        .window_classes = [this](const auto &app){ return windowClasses(app); },
+        .categories = [this](const auto &app){ return categories(app); }
+    };
+    current_snapshot.store(make_shared<const Generation>(generation, applications, keys),
+                           memory_order_release);
+
+    for (auto *o : vector(observers))  // Observers may unregister while notified
+        o->applicationsChanged(generation);
+}
+
+bool PluginBase::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == QCoreApplication::instance() && event->type() == QEvent::LanguageChange)
+        retranslate();
+    return ExtensionPlugin::eventFilter(watched, event);
+}
+
+void PluginBase::retranslate() { ApplicationBase::retranslate(); }
 
 void PluginBase::commonInitialize(const QSettings &s)
 {
     use_non_localized_name_ = s.value(ck_use_non_localized_name, false).value<bool>();
     split_camel_case_       = s.value(ck_split_camel_case, false).value<bool>();
     use_acronyms_           = s.value(ck_use_acronyms, false).value<bool>();
+    typo_tolerant_search_   = s.value(ck_typo_tolerant_search, false).value<bool>();
+    current_snapshot = make_shared<const Generation>(
+        generation, vector<shared_ptr<applications::Application>>{}, Generation::Keys{});
+    memory_accounting = qEnvironmentVariableIsSet("ALBERT_APPLICATIONS_MEMORY_ACCOUNTING");
+
+    const auto st = state();
+    st->beginGroup(sk_launch_counts);
+    for (const auto &id : st->childKeys())
+        launch_counts.emplace(id, st->value(id).toUInt());
+    st->endGroup();
+
+    // Action texts are translated once and refreshed on language changes only
+    retranslate();
+    QCoreApplication::instance()->installEventFilter(this);
 }
 
 void PluginBase::addBaseConfig(QFormLayout *l)
@@ -41,18 +207,43 @@ void PluginBase::addBaseConfig(QFormLayout *l)
     cb = new QCheckBox;
     l->addRow(tr("Use acronyms"), cb);
     bindWidget(cb, this, &PluginBase::useAcronyms, &PluginBase::setUseAcronyms);
+
+    cb = new QCheckBox;
+    cb->setToolTip(tr("Use a built-in matcher tolerating typos and matching words and acronyms "
+                      "of the names. Ranks by launch frequency too."));
+    l->addRow(tr("Typo tolerant search"), cb);
+    bindWidget(cb, this, &PluginBase::typoTolerantSearch, &PluginBase::setTypoTolerantSearch);
 }
 
-vector<IndexItem> PluginBase::buildIndexItems() const
+vector<IndexItem> PluginBase::buildIndexItems()
 {
     vector<IndexItem> r;
+    map<const applications::Application*, vector<IndexItem>> cache;
 
     for (const auto &iapp : applications)
     {
+        if (!isIndexed(*iapp))
+            continue;
+
+        auto &items = cache[iapp.get()];
+
+        // Reuse the items of applications kept from the previous generation. The cached
+        // items keep their application alive, hence the address can not be reused.
+        if (auto it = index_item_cache.find(iapp.get()); it != index_item_cache.end())
+        {
+            items = ::move(it->second);
+            r.insert(r.end(), items.begin(), items.end());
+            continue;
+        }
+
         auto app = static_pointer_cast<ApplicationBase>(iapp);
         for (const auto &name : app->names())
         {
-            r.emplace_back(app, name);
+            items.emplace_back(app, name);
+
+            // The search index matches words and acronyms itself
+            if (typo_tolerant_search_)
+                continue;
 
             // https://en.wikipedia.org/wiki/Combining_Diacritical_Marks
             static QRegularExpression re(uR"([\x{0300}-\x{036f}])"_s);
@@ -61,7 +252,7 @@ vector<IndexItem> PluginBase::buildIndexItems() const
             auto ccs = camelCaseSplit(normalized);
 
             if (split_camel_case_)
-                r.emplace_back(app, ccs.join(QChar::Space));
+                items.emplace_back(app, ccs.join(QChar::Space));
 
             if (use_acronyms_)
             {
@@ -71,14 +262,119 @@ vector<IndexItem> PluginBase::buildIndexItems() const
                         acronym.append(w[0]);
 
                 if (acronym.size() > 1)
-                    r.emplace_back(app, acronym);
+                    items.emplace_back(app, acronym);
             }
         }
+
+        addIndexItems(iapp, items);
+
+        r.insert(r.end(), items.begin(), items.end());
     }
 
+    index_item_cache = ::move(cache);
     return r;
 }
 
+void PluginBase::publishIndexItems()
+{
+    auto items = buildIndexItems();
+
+    if (memory_accounting)
+        accountMemory(items);
+
+    if (typo_tolerant_search_)
+    {
+        auto index = make_shared<const SearchIndex>(::move(items), launch_counts);
+        {
+            lock_guard lock(search_index_mutex);
+            search_index = ::move(index);
+        }
+        setIndexItems({});
+    }
+    else
+    {
+        {
+            lock_guard lock(search_index_mutex);
+            search_index.reset();
+        }
+        setIndexItems(::move(items));
+    }
+}
+
+bool PluginBase::isIndexed(const applications::Application &) const { return true; }
+
+void PluginBase::addIndexItems(const shared_ptr<applications::Application> &,
+                               vector<IndexItem> &) const {}
+
+PluginBase::Delta
+PluginBase::replaceApplications(vector<shared_ptr<applications::Application>> &&apps)
+{
+    map<QString, shared_ptr<applications::Application>> old;
+    for (auto &app : applications)
+        old.emplace(app->id(), ::move(app));
+
+    retired_applications.clear();
+
+    Delta d{.generation = generation, .added = {}, .removed = {}, .modified = {}};
+    for (auto &app : apps)
+        if (auto node = old.extract(app->id()); node.empty())
+            d.added << app->id();
+        else if (static_pointer_cast<ApplicationBase>(app)->equals(
+                     *static_pointer_cast<ApplicationBase>(node.mapped())))
+            app = ::move(node.mapped());
+        else
+        {
+            d.modified << app->id();
+            if (memory_accounting)
+                retired_applications.emplace_back(::move(node.mapped()));
+        }
+
+    for (auto &[id, app] : old)
+    {
+        d.removed << id;
+        if (memory_accounting)
+            retired_applications.emplace_back(::move(app));
+    }
+
+    applications = ::move(apps);
+
+    if (!d.empty())
+        d.generation = ++generation;
+
+    return d;
+}
+
+void PluginBase::accountMemory(const vector<IndexItem> &items)
+{
+    auto account = [&](MemoryReport &r)
+    {
+        r.add(MemoryReport::Objects,
+              applications.capacity() * sizeof(shared_ptr<applications::Application>));
+        for (const auto &app : applications)
+            if (r.addControlBlock(app.get()))
+                static_pointer_cast<ApplicationBase>(app)->accountMemory(r);
+        r.addIndexItems(items);
+    };
+
+    MemoryReport r;
+    account(r);
+
+    // The previous generation is alive while this one replaces it. Objects and strings of both,
+    // e.g. of unchanged applications, are counted once. The addresses seen by the previous
+    // report are not reused yet, since its retired applications and index items are alive.
+    auto added = MemoryReport::excluding(memory_report);
+    account(added);
+    memory_peak = max(memory_peak, memory_report.total() + added.total());
+    retired_applications.clear();
+
+    memory_report = ::move(r);
+
+    DEBG << u"Memory of %1 applications: %2. Peak of overlapping generations: %3 KiB."_s
+                .arg(applications.size())
+                .arg(memory_report.toString())
+                .arg(memory_peak / 1024.0, 0, 'f', 1);
+}
+
 QStringList PluginBase::camelCaseSplit(const QString &s)
 {
     static QRegularExpression re(uR"([A-Z0-9]?[a-z]+|[A-Z0-9]+(?![a-z]))"_s);
@@ -91,6 +387,30 @@ QStringList PluginBase::camelCaseSplit(const QString &s)
     return words;
 }
 
+void PluginBase::recordLaunch(const QString &id)
+{
+    const auto count = ++launch_counts[id];
+    const auto st = state();
+    st->beginGroup(sk_launch_counts);
+    st->setValue(id, count);
+}
+
+QStringList PluginBase::mostLaunched(uint n) const
+{
+    vector<pair<uint, QString>> sorted;
+    sorted.reserve(launch_counts.size());
+    for (const auto &[id, count] : launch_counts)
+        sorted.emplace_back(count, id);
+
+    n = min<uint>(n, sorted.size());
+    ranges::partial_sort(sorted, sorted.begin() + n, greater<>());
+
+    QStringList ids;
+    for (uint i = 0; i < n; ++i)
+        ids << sorted[i].second;
+    return ids;
+}
+
 bool PluginBase::useNonLocalizedName() const { return use_non_localized_name_; }
 
 void PluginBase::setUseNonLocalizedName(bool v)
@@ -111,7 +431,8 @@ void PluginBase::setSplitCamelCase(bool v)
     {
         settings()->setValue(ck_split_camel_case, v);
         split_camel_case_ = v;
-        setIndexItems(buildIndexItems());
+        index_item_cache.clear();
+        publishIndexItems();
     }
 }
 
@@ -123,6 +444,20 @@ void PluginBase::setUseAcronyms(bool v)
     {
         settings()->setValue(ck_use_acronyms, v);
         use_acronyms_ = v;
-        setIndexItems(buildIndexItems());
+        index_item_cache.clear();
+        publishIndexItems();
+    }
+}
+
+bool PluginBase::typoTolerantSearch() const { return typo_tolerant_search_; }
+
+void PluginBase::setTypoTolerantSearch(bool v)
+{
+    if (typo_tolerant_search_ != v)
+    {
+        settings()->setValue(ck_typo_tolerant_search, v);
+        typo_tolerant_search_ = v;
+        index_item_cache.clear();
+        publishIndexItems();
     }
 }
@@ -2,14 +2,19 @@
 
 #pragma once
 #include "applications.h"
+#include "memoryreport.h"
 #include <QFileSystemWatcher>
 #include <QStringList>
 #include <albert/backgroundexecutor.h>
 #include <albert/extensionplugin.h>
 #include <albert/indexqueryhandler.h>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 class QFormLayout;
+class SearchIndex;
 
 class PluginBase : public albert::ExtensionPlugin,
                    public albert::IndexQueryHandler,
@@ -18,8 +23,25 @@ class PluginBase : public albert::ExtensionPlugin,
     Q_OBJECT
 
 public:
+    /// The changes of an index run
+    struct Delta
+    {
+        quint64 generation;
+        QStringList added;  ///< Ids
+        QStringList removed;
+        QStringList modified;
+
+        bool empty() const;
+    };
+
     QString defaultTrigger() const override;
     void updateIndexItems() override;
+    std::vector<albert::RankItem> handleGlobalQuery(const albert::Query &) override;
+
+    // applications::Plugin
+    std::shared_ptr<const applications::Snapshot> snapshot() const override;
+    void addObserver(applications::Observer *) override;
+    void removeObserver(applications::Observer *) override;
 
     bool useNonLocalizedName() const;
     void setUseNonLocalizedName(bool);
@@ -30,23 +52,101 @@ public:
     bool useAcronyms() const;
     void setUseAcronyms(bool);
 
+    bool typoTolerantSearch() const;
+    void setTypoTolerantSearch(bool);
+
+    /// Counts a launch of the application with id _id_ in the persistent launch statistics.
+    void recordLaunch(const QString &id);
+
+    /// Returns the ids of the _n_ most frequently launched applications.
+    QStringList mostLaunched(uint n) const;
+
 protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+    virtual void retranslate();
     void commonInitialize(const QSettings &s);
     void addBaseConfig(QFormLayout *);
-    std::vector<albert::IndexItem> buildIndexItems() const;
+    std::vector<albert::IndexItem> buildIndexItems();
+    void publishIndexItems();
+
+    /// Replaces the applications by _apps_ and returns the changes. Applications having
+    /// unchanged content are kept, such that their objects outlive index runs.
+    /// Bumps the generation if anything changed.
+    Delta replaceApplications(std::vector<std::shared_ptr<applications::Application>> &&apps);
+    void accountMemory(const std::vector<albert::IndexItem> &);
+
+    /// Index run bookkeeping. To be called by indexer.parallel when it starts and returns.
+    void indexRunStarted();
+    void indexRunFinished(bool aborted);
+
+    /// Publishes a snapshot of the current generation and notifies the observers.
+    void publishSnapshot();
+
+    /// Returns the file name of the executable of _app_ or an empty string if unknown.
+    virtual QString executableName(const applications::Application &app) const = 0;
+
+    /// Returns the window classes of _app_ in order of precedence.
+    /// \sa applications::Snapshot::byWindowClass
+    virtual QStringList windowClasses(const applications::Application &app) const = 0;
+
+    /// Called in the query thread with the best ranked item of each query, e.g. to prepare
+    /// its activation.
+    virtual void topRankedItem(const albert::Item &item);
+
+    /// Returns false if _app_ should not be indexed, e.g. because another installation of it
+    /// is preferred. Thread-safe.
+    virtual bool isIndexed(const applications::Application &app) const;
+
+    /// Appends further index items of _app_ to _items_, e.g. for its actions.
+    /// Called by buildIndexItems() for each indexed application.
+    virtual void addIndexItems(const std::shared_ptr<applications::Application> &app,
+                               std::vector<albert::IndexItem> &items) const;
+
+    /// Returns the categories of _app_.
+    /// \sa applications::Snapshot::byCategory
+    virtual QStringList categories(const applications::Application &app) const = 0;
+
     static QStringList camelCaseSplit(const QString &s);
 
+    /// Returns the applications in all of _categories_ matching _string_.
+    std::vector<albert::RankItem> handleCategoryQuery(const QStringList &categories,
+                                                      const QString &string,
+                                                      const SearchIndex *index) const;
+
     QFileSystemWatcher fs_watcher;
     albert::BackgroundExecutor<std::vector<std::shared_ptr<applications::Application>>> indexer;
     std::vector<std::shared_ptr<applications::Application>> applications;
+    std::map<QString, uint> launch_counts;
+    std::map<const applications::Application*, std::vector<albert::IndexItem>> index_item_cache;
+    std::atomic<std::shared_ptr<const applications::Snapshot>> current_snapshot;
+    quint64 generation = 0;
+    std::vector<applications::Observer*> observers;
+    std::shared_ptr<const SearchIndex> search_index;
+    std::mutex search_index_mutex;
+
+    // Written by the indexer thread
+    std::atomic_bool index_running = false;
+    std::atomic_bool index_run_aborted = false;  // The result is incomplete
+    std::atomic<qint64> restart_requested = 0;  // Steady clock ns, 0 if none pending
+    std::atomic_uint index_runs_aborted = 0;
+    std::atomic_uint index_restarts = 0;
+    std::atomic<qint64> restart_ns = 0;  // Sum of the times from request to restart
+
+    // Enabled by the environment variable ALBERT_APPLICATIONS_MEMORY_ACCOUNTING
+    bool memory_accounting;
+    MemoryReport memory_report;  // The current generation
+    quint64 memory_peak = 0;  // Peak of overlapping generations
+    std::vector<std::shared_ptr<applications::Application>> retired_applications;  // Until accounted
 
     bool use_non_localized_name_;
     bool split_camel_case_;
     bool use_acronyms_;
+    bool typo_tolerant_search_;
 
 signals:
-    void appsChanged();
+    void appsChanged(const PluginBase::Delta &);
     void useNonLocalizedNameChanged(bool);
     void splitCamelCaseChanged(bool);
     void useAcronymsChanged(bool);
+    void typoTolerantSearchChanged(bool);
 };
@@ -0,0 +1,231 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "searchindex.h"
+#include <QRegularExpression>
+#include <algorithm>
+#include <unordered_map>
+using namespace Qt::StringLiterals;
+using namespace albert;
+using namespace std;
+
+static constexpr float frequency_weight = .1f;
+static constexpr float acronym_factor = .8f;
+
+// https://en.wikipedia.org/wiki/Combining_Diacritical_Marks
+static const QRegularExpression re_diacritics(uR"([\x{0300}-\x{036f}])"_s);
+static const QRegularExpression re_separators(uR"([^\p{L}\p{N}]+)"_s);
+static const QRegularExpression re_camel_case(uR"((\p{Lu}|\p{N})?[\p{Ll}\p{Lo}\p{Lm}]+|[\p{Lu}\p{N}]+(?!\p{Ll}))"_s);
+
+static QStringList queryWords(const QString &s)
+{
+    return s.normalized(QString::NormalizationForm_D).remove(re_diacritics).toCaseFolded()
+        .split(re_separators, Qt::SkipEmptyParts);
+}
+
+// Padded at the front only, such that the trigrams of a prefix are a subset of the trigrams
+// of the word.
+static vector<quint64> trigrams(const QString &word)
+{
+    const auto padded = u"  "_s + word;
+
+    vector<quint64> t;
+    t.reserve(word.size());
+    for (qsizetype i = 0; i + 2 < padded.size(); ++i)
+        t.push_back(quint64(padded[i].unicode()) << 32
+                    | quint64(padded[i + 1].unicode()) << 16
+                    | quint64(padded[i + 2].unicode()));
+
+    ranges::sort(t);
+    const auto [first, last] = ranges::unique(t);
+    t.erase(first, last);
+    return t;
+}
+
+static uint maxEdits(qsizetype length) { return length < 4 ? 0 : length < 7 ? 1 : 2; }
+
+// Returns the minimal optimal string alignment distance between _query_ and the prefixes of
+// _word_, or _max_ + 1 if it exceeds _max_.
+static uint prefixDistance(const QString &query, const QString &word, uint max)
+{
+    const auto m = query.size();
+    const auto n = word.size();
+    vector<uint> prev2(n + 1), prev(n + 1), cur(n + 1);
+
+    for (qsizetype j = 0; j <= n; ++j)
+        prev[j] = j;
+
+    for (qsizetype i = 1; i <= m; ++i)
+    {
+        cur[0] = i;
+        uint row_min = cur[0];
+
+        for (qsizetype j = 1; j <= n; ++j)
+        {
+            const uint cost = query[i - 1] == word[j - 1] ? 0 : 1;
+            cur[j] = min({prev[j] + 1, cur[j - 1] + 1, prev[j - 1] + cost});
+            if (i > 1 && j > 1 && query[i - 1] == word[j - 2] && query[i - 2] == word[j - 1])
+                cur[j] = min(cur[j], prev2[j - 2] + 1);
+            row_min = min(row_min, cur[j]);
+        }
+
+        if (row_min > max)
+            return max + 1;
+
+        swap(prev2, prev);
+        swap(prev, cur);
+    }
+
+    return ranges::min(prev);
+}
+
+SearchIndex::SearchIndex(vector<IndexItem> &&items, const map<QString, uint> &launch_counts)
+{
+    uint max_count = 1;
+    for (const auto &[id, count] : launch_counts)
+        max_count = max(max_count, count);
+
+    entries_.reserve(items.size());
+    for (auto &index_item : items)
+    {
+        const auto stripped = index_item.string.normalized(QString::NormalizationForm_D)
+                                  .remove(re_diacritics);
+
+        Entry e{
+            .item = ::move(index_item.item),
+            .words = {},
+            .length = static_cast<uint>(stripped.size()),
+            .has_acronym = false,
+            .frequency = 0
+        };
+
+        if (auto it = launch_counts.find(e.item->id()); it != launch_counts.end())
+            e.frequency = float(it->second) / max_count;
+
+        QString acronym;
+        for (const auto &token : stripped.split(re_separators, Qt::SkipEmptyParts))
+        {
+            e.words.emplace_back(token.toCaseFolded());
+
+            QStringList parts;
+            for (auto it = re_camel_case.globalMatch(token); it.hasNext();)
+                parts << it.next().captured();
+
+            for (const auto &part : as_const(parts))
+                acronym.append(part[0]);
+
+            if (parts.size() > 1)
+                for (const auto &part : as_const(parts))
+                    e.words.emplace_back(part.toCaseFolded());
+        }
+
+        if (acronym.size() > 1)
+        {
+            e.words.emplace_back(acronym.toCaseFolded());
+            e.has_acronym = true;
+        }
+
+        if (e.words.empty())
+            continue;
+
+        const auto index = static_cast<uint>(entries_.size());
+        for (const auto &word : e.words)
+            for (const auto t : trigrams(word))
+                if (auto &list = postings_[t]; list.empty() || list.back() != index)
+                    list.push_back(index);  // Sorted and unique, since indices are ascending
+
+        entries_.emplace_back(::move(e));
+    }
+}
+
+float SearchIndex::score(const Entry &e, const QStringList &query_words) const
+{
+    uint matched = 0;
+    uint edits = 0;
+    bool acronym = false;
+
+    for (const auto &query_word : query_words)
+    {
+        const auto max = maxEdits(query_word.size());
+        auto best = max + 1;
+        size_t best_word = 0;
+
+        for (size_t w = 0; w < e.words.size() && best > 0; ++w)
+            if (auto d = prefixDistance(query_word, e.words[w], max); d < best)
+            {
+                best = d;
+                best_word = w;
+            }
+
+        if (best > max)
+            return 0;
+
+        matched += query_word.size();
+        edits += best;
+        acronym |= e.has_acronym && best_word == e.words.size() - 1;
+    }
+
+    auto s = min(1.f, float(matched) / e.length) / (1 + edits);
+    if (acronym)
+        s *= acronym_factor;
+    return (1 - frequency_weight) * s + frequency_weight * e.frequency;
+}
+
+vector<RankItem> SearchIndex::search(const QString &query) const
+{
+    // Separators only, e.g. a trailing space of a global query. Matching everything would
+    // rank by launch frequency alone.
+    const auto query_words = queryWords(query);
+    if (query_words.isEmpty())
+        return {};
+
+    // Gather the entries having enough trigrams in common with every query word
+    vector<uint> candidates;
+    unordered_map<uint, uint> counts;  // Sparse, the entries sharing a trigram only
+
+    for (qsizetype w = 0; w < query_words.size(); ++w)
+    {
+        const auto query_trigrams = trigrams(query_words[w]);
+        const auto max = maxEdits(query_words[w].size());
+
+        // A substitution invalidates at most three trigrams, a transposition of adjacent
+        // characters, which counts as one edit, four
+        const auto threshold = query_trigrams.size() > 4 * max
+                                   ? query_trigrams.size() - 4 * max : 1;
+
+        counts.clear();
+        vector<uint> hits;
+        for (const auto t : query_trigrams)
+            if (auto it = postings_.find(t); it != postings_.end())
+                for (const auto entry : it->second)
+                    if (++counts[entry] == threshold)
+                        hits.push_back(entry);
+
+        ranges::sort(hits);
+
+        if (w == 0)
+            candidates = ::move(hits);
+        else
+        {
+            vector<uint> intersection;
+            ranges::set_intersection(candidates, hits, back_inserter(intersection));
+            candidates = ::move(intersection);
+        }
+
+        if (candidates.empty())
+            return {};
+    }
+
+    // Verify and score the candidates
+    unordered_map<const Item*, pair<shared_ptr<Item>, float>> best;
+    for (const auto index : candidates)
+        if (const auto &e = entries_[index]; const auto s = score(e, query_words))
+            if (auto [it, inserted] = best.emplace(e.item.get(), pair{e.item, s});
+                !inserted && it->second.second < s)
+                it->second.second = s;
+
+    vector<RankItem> results;
+    results.reserve(best.size());
+    for (auto &[ptr, match] : best)
+        results.emplace_back(::move(match.first), match.second);
+    return results;
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QString>
+#include <albert/indexitem.h>
+#include <albert/rankitem.h>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+///
+/// Typo tolerant trigram index over item names.
+///
+/// Names are normalized (case folded, diacritics removed) and split into words at separators
+/// and medial capitals. Each word and the acronym of the name are indexed by their trigrams,
+/// padded at the front such that short queries match word prefixes.
+///
+/// A query word matches a name word if it is a prefix of it with a bounded number of edits
+/// (optimal string alignment distance). Candidates are gathered from sorted posting lists and
+/// verified, hence query time depends on the number of candidates rather than on the number
+/// of indexed names.
+///
+class SearchIndex
+{
+public:
+
+    /// Builds the index for _items_. _launch_counts_ maps item ids to launch counts, which
+    /// are blended into the ranking.
+    SearchIndex(std::vector<albert::IndexItem> &&items,
+                const std::map<QString, uint> &launch_counts);
+
+    /// Returns the items matching _query_. Each item is returned at most once. Returns no items
+    /// if _query_ has no words.
+    std::vector<albert::RankItem> search(const QString &query) const;
+
+private:
+
+    struct Entry
+    {
+        std::shared_ptr<albert::Item> item;
+        std::vector<QString> words;  // The last word is the acronym, if any
+        uint length;  // Length of the normalized string
+        bool has_acronym;
+        float frequency;  // Launch count relative to the maximum
+    };
+
+    float score(const Entry &, const QStringList &query_words) const;
+
+    std::vector<Entry> entries_;
+    std::unordered_map<quint64, std::vector<uint>> postings_;
+
+};
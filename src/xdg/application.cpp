@@ -1,35 +1,65 @@
 // Copyright (c) 2022-2025 Manuel Schneider
 
 #include "application.h"
-#include "plugin.h"
+#include "desktopentry.h"
+#include "executableindex.h"
+#include "memoryreport.h"
+#include <QDataStream>
 #include <QFileInfo>
+#include <QSet>
 #include <albert/desktopentryparser.h>
 #include <albert/icon.h>
 #include <albert/logging.h>
-#include <albert/systemutil.h>
+#include <mutex>
 #include <ranges>
 using namespace Qt::StringLiterals;
 using namespace albert::detail;
 using namespace albert;
 using namespace std;
 
-extern Plugin* plugin;
+// Few distinct categories are shared by many applications. Interning them shares the
+// string data between the applications and makes the category facet hash shared keys.
+static void intern(QStringList &categories)
+{
+    static mutex m;
+    static QSet<QString> pool;
+    lock_guard lock(m);
+    for (auto &category : categories)
+        category = *pool.insert(category);
+}
+
+quint8 Application::ParseOptions::flags() const
+{
+    return quint8(hide_missing_executables)
+           | quint8(ignore_show_in_keys) << 1
+           | quint8(use_exec) << 2
+           | quint8(use_generic_name) << 3
+           | quint8(use_keywords) << 4
+           | quint8(use_non_localized_name) << 5;
+}
+
+Application::Application(const QString &id, const QString &path, ParseOptions po):
+    Application(id, path, DesktopEntry::read(path), po)
+{}
 
-Application::Application(const QString &id, const QString &path, ParseOptions po)
+Application::Application(const QString &id, const QString &path, const QByteArray &content,
+                         ParseOptions po)
 {
     id_ = id;
     path_ = path;
 
-    DesktopEntryParser p(path);
+    const DesktopEntry p(content);
     auto root_section = u"Desktop Entry"_s;
 
-    // Post a warning on unsupported terminals
+    // Categories - string(s)
     try {
-        if (ranges::any_of(p.getString(root_section, u"Categories"_s).split(u';', Qt::SkipEmptyParts),
-                           [&](const auto &cat){ return cat == u"TerminalEmulator"_s; }))
-            is_terminal_ = true;
+        categories_ = p.getString(root_section, u"Categories"_s).split(u';', Qt::SkipEmptyParts);
+        intern(categories_);
     } catch (const out_of_range &) { }
 
+    // Post a warning on unsupported terminals
+    is_terminal_ = categories_.contains(u"TerminalEmulator"_s);
+
     // Type - string, REQUIRED to be Application
     if (p.getString(root_section, u"Type"_s) != u"Application"_s)
         throw runtime_error("Desktop entries of type other than 'Application' are not handled yet.");
@@ -40,6 +70,12 @@ Application::Application(const QString &id, const QString &path, ParseOptions po
             throw runtime_error("Desktop entry excluded by 'NoDisplay'.");
     } catch (const out_of_range &) { }
 
+    // TryExec - string, if exists has to be an executable
+    try {
+        if (!po.executables->contains(p.getString(root_section, u"TryExec"_s)))
+            throw runtime_error("Desktop entry excluded by 'TryExec'.");
+    } catch (const out_of_range &) { }
+
     if (!po.ignore_show_in_keys)
     {
         const auto desktops(qEnvironmentVariable("XDG_CURRENT_DESKTOP").split(u':', Qt::SkipEmptyParts));
@@ -79,6 +115,9 @@ Application::Application(const QString &id, const QString &path, ParseOptions po
         throw runtime_error("Malformed Exec value.");
     }
 
+    if (po.hide_missing_executables && !po.executables->contains(exec_.at(0)))
+        throw runtime_error("Exec executable not found.");
+
     if (po.use_exec)
     {
         static QStringList excludes = {
@@ -127,6 +166,26 @@ Application::Application(const QString &id, const QString &path, ParseOptions po
         term_ = p.getBoolean(root_section, u"Terminal"_s);
     } catch (const out_of_range &) { }
 
+    // StartupNotify - boolean
+    try {
+        startup_notify_ = p.getBoolean(root_section, u"StartupNotify"_s);
+    } catch (const out_of_range &) { }
+
+    // StartupWMClass - string
+    try {
+        startup_wm_class_ = p.getString(root_section, u"StartupWMClass"_s);
+    } catch (const out_of_range &) { }
+
+    // X-Flatpak - string, the flatpak app-id, set by flatpak on export
+    try {
+        flatpak_id_ = p.getString(root_section, u"X-Flatpak"_s);
+    } catch (const out_of_range &) { }
+
+    // DBusActivatable - boolean
+    try {
+        dbus_activatable_ = p.getBoolean(root_section, u"DBusActivatable"_s);
+    } catch (const out_of_range &) { }
+
     // GenericName - localestring
     if (po.use_generic_name)
         try {
@@ -143,21 +202,6 @@ Application::Application(const QString &id, const QString &path, ParseOptions po
             {
                 const auto action_section = u"Desktop Action %1"_s.arg(action_id);
 
-                // TOdo
-                auto action = Action(
-                    action_id,
-                    p.getLocaleString(action_section, u"Name"_s), // Name - localestring, REQUIRED
-                    [this, &p, &action_section]{
-                        auto exec = DesktopEntryParser::splitExec(p.getString(action_section, u"Exec"_s));
-                        if (!exec)
-                            throw runtime_error("Malformed Exec value.");
-                        else if (exec.value().isEmpty())
-                            throw runtime_error("Empty Exec value.");
-                        else
-                            runDetachedProcess(fieldCodesExpanded(exec.value(), QUrl()));
-                    }
-                );
-
                 // Name - localestring, REQUIRED
                 auto name = p.getLocaleString(action_section, u"Name"_s);
 
@@ -168,7 +212,8 @@ Application::Application(const QString &id, const QString &path, ParseOptions po
                 else if (exec.value().isEmpty())
                     throw runtime_error("Empty Exec value.");
                 else
-                    desktop_actions_.emplace_back(*this, action_id, name, exec.value());
+                    desktop_actions_.emplace_back(action_id, u"action-%1"_s.arg(action_id),
+                                                  name, exec.value());
             }
             catch (const out_of_range &e)
             {
@@ -185,30 +230,48 @@ Application::Application(const QString &id, const QString &path, ParseOptions po
     // pe.mime_types.removeDuplicates();
 
     names_.removeDuplicates();
+    compileCommandlines();
 }
 
-QString Application::subtext() const { return description_; }
-
-unique_ptr<Icon> Application::icon() const
+Application::Application(QDataStream &s)
 {
-    if (QFileInfo(icon_).isAbsolute())
-        return Icon::image(icon_);
-    else
-        return Icon::theme(icon_);
+    quint32 action_count;
+    s >> id_ >> path_ >> names_ >> description_ >> icon_ >> exec_ >> working_dir_
+      >> startup_wm_class_ >> flatpak_id_ >> categories_ >> term_ >> is_terminal_ >> startup_notify_
+      >> dbus_activatable_ >> action_count;
+
+    for (quint32 i = 0; i < action_count && s.status() == QDataStream::Ok; ++i)
+    {
+        DesktopAction a;
+        s >> a.id_ >> a.action_id_ >> a.name_ >> a.exec_;
+        desktop_actions_.emplace_back(::move(a));
+    }
+
+    if (s.status() != QDataStream::Ok || names_.isEmpty() || exec_.isEmpty())
+        throw runtime_error("Failed to deserialize application.");
+
+    intern(categories_);
+    compileCommandlines();
 }
 
-vector<Action> Application::actions() const
+void Application::serialize(QDataStream &s) const
 {
-    vector<Action> actions = ApplicationBase::actions();
+    s << id_ << path_ << names_ << description_ << icon_ << exec_ << working_dir_
+      << startup_wm_class_ << flatpak_id_ << categories_ << term_ << is_terminal_ << startup_notify_
+      << dbus_activatable_ << quint32(desktop_actions_.size());
 
     for (const auto &a : desktop_actions_)
-        actions.emplace_back(u"action-%1"_s.arg(a.id_), a.name_, [&a]{ a.launch(); });
+        s << a.id_ << a.action_id_ << a.name_ << a.exec_;
+}
 
-    actions.emplace_back(u"reveal-entry"_s,
-                         Plugin::tr("Open desktop entry"),
-                         [this] { open(path_); });
+QString Application::subtext() const { return description_; }
 
-    return actions;
+unique_ptr<Icon> Application::icon() const
+{
+    if (QFileInfo(icon_).isAbsolute())
+        return Icon::image(icon_);
+    else
+        return Icon::theme(icon_);
 }
 
 const QStringList &Application::exec() const
@@ -218,25 +281,67 @@ const QStringList &Application::exec() const
 
 bool Application::isTerminal() const { return is_terminal_; }
 
-void Application::launchExec(const QStringList &exec, QUrl url, const QString &working_dir) const
-{
-    auto commandline = fieldCodesExpanded(exec, url);
-    auto wd = working_dir.isEmpty() ? working_dir_ : working_dir;
+bool Application::isDBusActivatable() const { return dbus_activatable_ && !term_; }
 
-    if (auto prefix = qEnvironmentVariable("ALBERT_APPLICATIONS_COMMAND_PREFIX")
-                          .split(u';', Qt::SkipEmptyParts);
-        !prefix.isEmpty())
-        commandline = prefix + commandline;
+const QString &Application::startupWMClass() const { return startup_wm_class_; }
 
-    if (term_)
-        plugin->runTerminal(commandline, wd);
-    else
-        runDetachedProcess(commandline, wd);
+const QString &Application::flatpakId() const { return flatpak_id_; }
+
+const QStringList &Application::categories() const { return categories_; }
+
+bool Application::equals(const ApplicationBase &other) const
+{
+    auto *o = dynamic_cast<const Application *>(&other);
+    return o
+           && ApplicationBase::equals(other)
+           && description_ == o->description_
+           && icon_ == o->icon_
+           && exec_ == o->exec_
+           && working_dir_ == o->working_dir_
+           && startup_wm_class_ == o->startup_wm_class_
+           && flatpak_id_ == o->flatpak_id_
+           && categories_ == o->categories_
+           && desktop_actions_ == o->desktop_actions_
+           && term_ == o->term_
+           && is_terminal_ == o->is_terminal_
+           && startup_notify_ == o->startup_notify_
+           && dbus_activatable_ == o->dbus_activatable_;
+}
+
+void Application::accountMemory(MemoryReport &r) const
+{
+    ApplicationBase::accountMemory(r);
+    r.add(MemoryReport::Objects, sizeof(Application) - sizeof(ApplicationBase));
+    r.addString(description_);
+    r.addString(icon_);
+    r.addString(working_dir_);
+    r.addString(startup_wm_class_);
+    r.addString(flatpak_id_);
+    r.addStringList(exec_);
+    r.addStringList(commandline_);
+    r.addStringList(categories_);
+
+    r.add(MemoryReport::Actions, desktop_actions_.capacity() * sizeof(DesktopAction));
+    for (const auto &a : desktop_actions_)
+    {
+        r.addString(a.id_, MemoryReport::Actions);
+        r.addString(a.action_id_, MemoryReport::Actions);
+        r.addString(a.name_, MemoryReport::Actions);
+        r.addStringList(a.exec_, MemoryReport::Actions);
+        r.addStringList(a.commandline_, MemoryReport::Actions);
+    }
 }
 
-void Application::launch() const { launchExec(exec_, {}, {}); }
+const vector<Application::DesktopAction> &Application::desktopActions() const
+{ return desktop_actions_; }
 
-void Application::DesktopAction::launch() const { application.launchExec(exec_, {}, {}); }
+// Launches without URL have command lines known at index time. Unchanged tokens share data.
+void Application::compileCommandlines()
+{
+    commandline_ = fieldCodesExpanded(exec_);
+    for (auto &a : desktop_actions_)
+        a.commandline_ = fieldCodesExpanded(a.exec_);
+}
 
 QStringList Application::fieldCodesExpanded(const QStringList &exec, QUrl url) const
 {
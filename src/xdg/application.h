@@ -2,56 +2,109 @@
 
 #pragma once
 #include "applicationbase.h"
+#include "launcher.h"
 #include <QString>
 #include <QUrl>
+class QDataStream;
+class ExecutableIndex;
 
 class Application : public ApplicationBase
 {
 public:
 
+    struct DesktopAction {
+        QString id_;
+        QString action_id_;  // Item action id, built once at index time
+        QString name_;
+        QStringList exec_;
+        QStringList commandline_;  // Field codes expanded, built once at index time
+
+        bool operator==(const DesktopAction &) const = default;
+    };
+
     struct ParseOptions
     {
+        bool hide_missing_executables;
         bool ignore_show_in_keys;
         bool use_exec;
         bool use_generic_name;
         bool use_keywords;
         bool use_non_localized_name;
+        const ExecutableIndex *executables;  // Used to check TryExec and Exec
+
+        /// Returns the boolean options as bit set.
+        quint8 flags() const;
     };
 
+    /// Parses the desktop file at _path_. Throws on failure.
     Application(const QString &id, const QString &path, ParseOptions po);
+
+    /// Parses _content_ of the desktop file at _path_. Throws on failure.
+    Application(const QString &id, const QString &path, const QByteArray &content,
+                ParseOptions po);
     Application(const Application &) = default;
 
+    /// Reads an application written by serialize(). Throws runtime_error on failure.
+    explicit Application(QDataStream &);
+
+    void serialize(QDataStream &) const;
+
     QString subtext() const override;
     std::unique_ptr<albert::Icon> icon() const override;
     void launch() const override;
     std::vector<albert::Action> actions() const override;
+    bool equals(const ApplicationBase &) const override;
+    void accountMemory(MemoryReport &) const override;
 
     const QStringList &exec() const;
 
     bool isTerminal() const;
 
+    /// Returns true if the application is launched via org.freedesktop.Application.
+    bool isDBusActivatable() const;
+
+    const QString &startupWMClass() const;
+
+    const QString &flatpakId() const;
+
+    const QStringList &categories() const;
+
+    /// Updates the cached translations of the action texts.
+    static void retranslate();
+
+    const std::vector<DesktopAction> &desktopActions() const;
+
+    /// Launches the desktop action _action_ of this application.
+    void launchAction(const DesktopAction &action) const;
+
 protected:
 
     void launchExec(const QStringList &exec, QUrl url, const QString &working_dir) const;
 
-    struct DesktopAction {
-        const Application &application;
-        QString id_;
-        QString name_;
-        QStringList exec_;
-        void launch() const;
-    };
+    /// Like launchExec(), for command lines with expanded field codes.
+    void launchCommandline(QStringList commandline, const QString &working_dir) const;
+    Launcher::Launch preparedLaunch(QStringList commandline, const QString &working_dir) const;
+
+    static QString reveal_text_;
+    static QString launch_installation_text_;
 
 private:
 
     QStringList fieldCodesExpanded(const QStringList &exec, QUrl url = {}) const;
+    void compileCommandlines();
 
     QString description_;
     QString icon_;
     QStringList exec_;
+    QStringList commandline_;  // Field codes expanded, built once at index time
     QString working_dir_;
+    QString startup_wm_class_;
+    QString flatpak_id_;
+    QStringList categories_;
     std::vector<DesktopAction> desktop_actions_;
     bool term_ = false;
     bool is_terminal_ = false;
+    bool startup_notify_ = false;
+    bool dbus_activatable_ = false;
 
 };
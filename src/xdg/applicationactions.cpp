@@ -0,0 +1,130 @@
+// Copyright (c) 2022-2026 Manuel Schneider
+
+// Application behavior depending on the plugin instance. Kept separate from the desktop entry
+// parsing in application.cpp, such that the latter can be used without a plugin instance.
+
+#include "application.h"
+#include "plugin.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <albert/systemutil.h>
+using namespace Qt::StringLiterals;
+using namespace albert;
+using namespace std;
+
+extern Plugin* plugin;
+
+QString Application::reveal_text_;
+QString Application::launch_installation_text_;
+
+void Application::retranslate()
+{
+    reveal_text_ = Plugin::tr("Open desktop entry");
+    launch_installation_text_ = Plugin::tr("Launch %1 installation");
+}
+
+static QString startupId(const QString &id)
+{
+    // The X server time of the triggering event is not known, hence no _TIME suffix
+    static uint sequence = 0;
+    return u"albert-%1-%2-%3"_s.arg(QCoreApplication::applicationPid()).arg(id).arg(++sequence);
+}
+
+vector<Action> Application::actions() const
+{
+    const auto alternatives = plugin->alternatives(id_);
+
+    vector<Action> actions;
+    actions.reserve(desktop_actions_.size() + alternatives.size() + 2);
+
+    actions.emplace_back(u"launch"_s, launch_text_, [this]{ launch(); });
+
+    for (const auto &a : desktop_actions_)
+        actions.emplace_back(a.action_id_, a.name_, [this, &a]{ launchAction(a); });
+
+    for (const auto &alt : alternatives)
+        actions.emplace_back(u"launch-"_s + alt->id(),
+                             launch_installation_text_.arg(
+                                 Plugin::displayName(WrappedCommand(alt->exec()).source)),
+                             [alt]{ alt->launch(); });
+
+    actions.emplace_back(u"reveal-entry"_s, reveal_text_, [this]{ open(path_); });
+
+    return actions;
+}
+
+Launcher::Launch Application::preparedLaunch(QStringList commandline,
+                                             const QString &working_dir) const
+{
+    QElapsedTimer activated;
+    activated.start();
+
+    if (auto prefix = qEnvironmentVariable("ALBERT_APPLICATIONS_COMMAND_PREFIX")
+                          .split(u';', Qt::SkipEmptyParts);
+        !prefix.isEmpty())
+        commandline = prefix + commandline;
+
+    const auto startup_id = startupId(id_);
+
+    QStringList environment;
+    if (startup_notify_)
+        environment << u"DESKTOP_STARTUP_ID=%1"_s.arg(startup_id);
+
+    return {
+        .id = id_,
+        .commandline = commandline,
+        .working_dir = working_dir.isEmpty() ? working_dir_ : working_dir,
+        .environment = environment,
+        .startup_id = startup_id,
+        .activated = activated,
+        .profile = plugin->launchProfile(id_, categories_)
+    };
+}
+
+void Application::launchExec(const QStringList &exec, QUrl url, const QString &working_dir) const
+{ launchCommandline(fieldCodesExpanded(exec, url), working_dir); }
+
+void Application::launchCommandline(QStringList commandline, const QString &working_dir) const
+{
+    auto launch = preparedLaunch(::move(commandline), working_dir);
+    if (term_)
+        plugin->runTerminal(launch.commandline, launch.working_dir);
+    else
+        plugin->runDetached(::move(launch));
+}
+
+void Application::launch() const
+{
+    // The launch statistics and the activation state belong to the plugin thread. Queues a
+    // copy, since other threads may release the application of an old snapshot meanwhile.
+    if (QThread::currentThread() != plugin->thread())
+    {
+        QMetaObject::invokeMethod(plugin, [app = *this]{ app.launch(); }, Qt::QueuedConnection);
+        return;
+    }
+
+    plugin->recordLaunch(id_);
+
+    // Activating a running instance is an IPC call instead of a process spawn
+    if (isDBusActivatable())
+        plugin->activateDBus({}, preparedLaunch(commandline_, {}));
+    else
+        launchCommandline(commandline_, {});
+}
+
+void Application::launchAction(const DesktopAction &a) const
+{
+    if (QThread::currentThread() != plugin->thread())
+    {
+        QMetaObject::invokeMethod(plugin, [app = *this, a]{ app.launchAction(a); },
+                                  Qt::QueuedConnection);
+        return;
+    }
+
+    plugin->recordLaunch(id_);
+    if (isDBusActivatable())
+        plugin->activateDBus(a.id_, preparedLaunch(a.commandline_, {}));
+    else
+        launchCommandline(a.commandline_, {});
+}
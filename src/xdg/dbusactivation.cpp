@@ -0,0 +1,32 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "dbusactivation.h"
+#include <QVariantList>
+#include <QVariantMap>
+using namespace Qt::StringLiterals;
+
+QString DBusActivation::objectPath(const QString &id)
+{ return u'/' + QString(id).replace(u'.', u'/').replace(u'-', u'_'); }
+
+QDBusMessage DBusActivation::message(const QString &id, const QString &action,
+                                     const QString &startup_id)
+{
+    // No 'activation-token', xdg-activation tokens have to be issued by the compositor
+    QVariantMap platform_data;
+    platform_data.insert(u"desktop-startup-id"_s, startup_id);
+
+    QDBusMessage msg;
+    if (action.isEmpty())
+    {
+        msg = QDBusMessage::createMethodCall(id, objectPath(id),
+                                             u"org.freedesktop.Application"_s, u"Activate"_s);
+        msg << platform_data;
+    }
+    else
+    {
+        msg = QDBusMessage::createMethodCall(id, objectPath(id),
+                                             u"org.freedesktop.Application"_s, u"ActivateAction"_s);
+        msg << action << QVariantList() << platform_data;
+    }
+    return msg;
+}
@@ -0,0 +1,24 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QDBusMessage>
+#include <QString>
+
+///
+/// Messages of the org.freedesktop.Application interface.
+///
+/// See https://specifications.freedesktop.org/desktop-entry-spec/latest/dbus.html
+///
+class DBusActivation
+{
+public:
+
+    /// Returns the object path of the application with the desktop id _id_.
+    static QString objectPath(const QString &id);
+
+    /// Returns the message activating the application with the desktop id _id_, or its
+    /// desktop action _action_ if not empty. _startup_id_ is passed in the platform data.
+    static QDBusMessage message(const QString &id, const QString &action,
+                                const QString &startup_id);
+
+};
@@ -0,0 +1,27 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "desktopactionitem.h"
+#include <albert/icon.h>
+using namespace albert;
+using namespace std;
+
+DesktopActionItem::DesktopActionItem(shared_ptr<const Application> application,
+                                     const Application::DesktopAction &action):
+    application_(::move(application)),
+    action_(action)
+{}
+
+QString DesktopActionItem::id() const { return application_->id() + u'/' + action_.id_; }
+
+QString DesktopActionItem::text() const { return action_.name_; }
+
+QString DesktopActionItem::subtext() const { return application_->name(); }
+
+QString DesktopActionItem::inputActionText() const { return action_.name_; }
+
+unique_ptr<Icon> DesktopActionItem::icon() const { return application_->icon(); }
+
+vector<Action> DesktopActionItem::actions() const
+{
+    return {{action_.action_id_, action_.name_, [this]{ application_->launchAction(action_); }}};
+}
@@ -0,0 +1,33 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include "application.h"
+#include <albert/item.h>
+#include <memory>
+
+///
+/// A desktop action of an application as item of its own.
+///
+/// References the action of the application, hence shares its strings, icon and
+/// precompiled command line.
+///
+class DesktopActionItem : public albert::Item
+{
+public:
+
+    DesktopActionItem(std::shared_ptr<const Application> application,
+                      const Application::DesktopAction &action);
+
+    QString id() const override;
+    QString text() const override;
+    QString subtext() const override;
+    QString inputActionText() const override;
+    std::unique_ptr<albert::Icon> icon() const override;
+    std::vector<albert::Action> actions() const override;
+
+private:
+
+    const std::shared_ptr<const Application> application_;
+    const Application::DesktopAction &action_;  // Owned by application_
+
+};
@@ -0,0 +1,151 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "desktopentry.h"
+#include <QFile>
+#include <QLocale>
+#include <QStringList>
+#include <QScopeGuard>
+#include <cerrno>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace Qt::StringLiterals;
+using namespace std;
+
+// https://specifications.freedesktop.org/desktop-entry-spec/latest/value-types.html
+// Escaped semicolons of lists are kept, such that lists can be split afterwards.
+static QString unescaped(const QString &value)
+{
+    QString s;
+    s.reserve(value.size());
+    for (qsizetype i = 0; i < value.size(); ++i)
+        if (value[i] != u'\\' || i + 1 == value.size())
+            s.append(value[i]);
+        else
+            switch (const auto c = value[++i]; c.unicode())
+            {
+            case 's': s.append(u' '); break;
+            case 'n': s.append(u'\n'); break;
+            case 't': s.append(u'\t'); break;
+            case 'r': s.append(u'\r'); break;
+            case '\\': s.append(u'\\'); break;
+            default: s.append(u'\\').append(c);
+            }
+    return s;
+}
+
+DesktopEntry::DesktopEntry(const QByteArray &content)
+{
+    QHash<QString, QString> *section = nullptr;
+    for (const auto &raw_line : content.split('\n'))
+    {
+        const auto line = QString::fromUtf8(raw_line).trimmed();
+
+        if (line.isEmpty() || line.startsWith(u'#'))
+            continue;
+
+        else if (line.startsWith(u'[') && line.endsWith(u']'))
+            section = &sections_[line.mid(1, line.size() - 2)];
+
+        else if (const auto eq = line.indexOf(u'='); eq > 0 && section)
+        {
+            // Keys must not appear twice, the first one wins
+            if (const auto key = line.left(eq).trimmed(); !section->contains(key))
+                section->insert(key, line.mid(eq + 1).trimmed());
+        }
+    }
+}
+
+const QString *DesktopEntry::value(const QString &section, const QString &key) const
+{
+    if (auto s = sections_.constFind(section); s != sections_.cend())
+        if (auto v = s->constFind(key); v != s->cend())
+            return &*v;
+    return nullptr;
+}
+
+QString DesktopEntry::getString(const QString &section, const QString &key) const
+{
+    if (const auto *v = value(section, key))
+        return unescaped(*v);
+    throw out_of_range("Key not found: " + key.toStdString());
+}
+
+QString DesktopEntry::getLocaleString(const QString &section, const QString &key,
+                                      const QString &locale) const
+{
+    // lang_COUNTRY.ENCODING@MODIFIER, the encoding is ignored
+    const auto at = locale.indexOf(u'@');
+    const auto modifier = at < 0 ? QString() : locale.mid(at + 1);
+    const auto lang_country = locale.left(at).section(u'.', 0, 0);
+    const auto lang = lang_country.section(u'_', 0, 0);
+
+    QStringList lookup;
+    if (lang_country != lang && !modifier.isEmpty())
+        lookup << u"%1@%2"_s.arg(lang_country, modifier);
+    if (lang_country != lang)
+        lookup << lang_country;
+    if (!modifier.isEmpty())
+        lookup << u"%1@%2"_s.arg(lang, modifier);
+    lookup << lang;
+
+    for (const auto &l : lookup)
+        if (const auto *v = value(section, u"%1[%2]"_s.arg(key, l)))
+            return unescaped(*v);
+    return getString(section, key);
+}
+
+bool DesktopEntry::getBoolean(const QString &section, const QString &key) const
+{
+    // Like GLib, which most desktop files are tested against
+    if (const auto v = getString(section, key); v == u"true"_s || v == u"1"_s)
+        return true;
+    else if (v == u"false"_s || v == u"0"_s)
+        return false;
+    throw runtime_error("Invalid boolean value of key: " + key.toStdString());
+}
+
+QString DesktopEntry::messagesLocale()
+{
+    auto locale = QLocale().name();
+
+    // The first variable set takes precedence, like in setlocale(3)
+    for (const auto *var : {"LC_ALL", "LC_MESSAGES", "LANG"})
+        if (const auto env = qEnvironmentVariable(var); !env.isEmpty())
+        {
+            if (const auto at = env.indexOf(u'@');
+                at >= 0 && env.section(u'_', 0, 0).section(u'.', 0, 0).section(u'@', 0, 0)
+                               == locale.section(u'_', 0, 0))
+                locale += env.mid(at);
+            break;
+        }
+
+    return locale;
+}
+
+QByteArray DesktopEntry::read(const QString &path, qint64 max_size)
+{
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        throw runtime_error("Failed to open desktop file.");
+    const auto guard = qScopeGuard([fd]{ ::close(fd); });
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+        throw runtime_error("Desktop file is not a regular file.");
+    else if (st.st_size > max_size)
+        throw runtime_error("Desktop file exceeds the size limit.");
+
+    QByteArray bytes(st.st_size, Qt::Uninitialized);
+    qsizetype n = 0;
+    while (n < bytes.size())
+        if (const auto r = ::read(fd, bytes.data() + n, bytes.size() - n); r > 0)
+            n += r;
+        else if (r == 0)
+            break;  // Truncated meanwhile
+        else if (errno != EINTR)
+            throw runtime_error("Failed to read desktop file.");
+    bytes.truncate(n);
+    return bytes;
+}
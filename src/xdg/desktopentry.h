@@ -0,0 +1,53 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <limits>
+
+///
+/// Desktop entry parsed from memory.
+///
+/// Counterpart of albert's DesktopEntryParser, which opens the file by path itself. Parsing
+/// content read by read() ensures the file is read once.
+///
+/// The getters throw out_of_range if the section or key does not exist.
+///
+class DesktopEntry
+{
+public:
+
+    /// Parses the desktop entry _content_.
+    explicit DesktopEntry(const QByteArray &content);
+
+    /// Returns the unescaped value of _key_ in _section_.
+    QString getString(const QString &section, const QString &key) const;
+
+    /// Returns the value of _key_ in _section_ localized for _locale_, if available.
+    /// _locale_ is a POSIX locale name, `lang_COUNTRY.ENCODING@MODIFIER`, of which all but
+    /// the language are optional. Looks up the keys in the order of the specification,
+    /// i.e. `lang_COUNTRY@MODIFIER`, `lang_COUNTRY`, `lang@MODIFIER`, `lang` and _key_.
+    QString getLocaleString(const QString &section, const QString &key,
+                            const QString &locale = messagesLocale()) const;
+
+    /// Returns the boolean value of _key_ in _section_. Throws runtime_error if invalid.
+    bool getBoolean(const QString &section, const QString &key) const;
+
+    /// Returns the name of QLocale() with the modifier of the messages locale set in the
+    /// environment, if any, e.g. 'sr_RS@latin'. QLocale does not keep modifiers.
+    static QString messagesLocale();
+
+    /// Reads the file at _path_. Opens non-blocking, such that opening FIFOs does not block,
+    /// and reads regular files of at most _max_size_ bytes only. Throws runtime_error
+    /// otherwise. Reads of regular files block nonetheless, e.g. on hung network mounts.
+    static QByteArray read(const QString &path,
+                           qint64 max_size = std::numeric_limits<qint64>::max());
+
+private:
+
+    const QString *value(const QString &section, const QString &key) const;
+
+    QHash<QString, QHash<QString, QString>> sections_;  // Section > key > raw value
+
+};
@@ -0,0 +1,335 @@
+// Copyright (c) 2022-2026 Manuel Schneider
+
+#include "desktopentry.h"
+#include "desktopentryindexer.h"
+#include "directorywalk.h"
+#include "executableindex.h"
+#include "prebuiltindex.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <albert/logging.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+using namespace Qt::StringLiterals;
+using namespace std;
+
+// Runs jobs on a thread of its own, such that a job blocking on a hung mount can be
+// abandoned. An abandoned thread exits once its job returns, if ever. Subsequent jobs are
+// run on a new thread. Jobs must not reference state of the caller, it may be gone by then.
+class TimedWorker
+{
+public:
+
+    ~TimedWorker() { abandon(); }
+
+    // Returns false if _job_ did not finish within _timeout_ms_. Rethrows its exceptions.
+    bool run(function<void()> job, qint64 timeout_ms)
+    {
+        if (!state_)
+        {
+            state_ = make_shared<State>();
+            thread(serve, state_).detach();
+        }
+
+        unique_lock lock(state_->mutex_);
+        state_->job_ = ::move(job);
+        state_->done_ = false;
+        state_->cv_.notify_all();
+
+        if (!state_->cv_.wait_for(lock, chrono::milliseconds(max(timeout_ms, 0ll)),
+                                  [this]{ return state_->done_; }))
+        {
+            lock.unlock();
+            abandon();
+            return false;
+        }
+
+        if (auto error = ::move(state_->error_); error)
+            rethrow_exception(error);
+        return true;
+    }
+
+private:
+
+    struct State
+    {
+        mutex mutex_;
+        condition_variable cv_;
+        function<void()> job_;
+        exception_ptr error_;
+        bool done_ = false;
+        bool quit_ = false;
+    };
+
+    static void serve(shared_ptr<State> state)
+    {
+        unique_lock lock(state->mutex_);
+        while (true)
+        {
+            state->cv_.wait(lock, [&]{ return state->quit_ || state->job_; });
+            if (state->quit_)
+                return;
+
+            auto job = ::move(state->job_);
+            state->job_ = nullptr;
+            lock.unlock();
+
+            exception_ptr error;
+            try {
+                job();
+            } catch (...) {
+                error = current_exception();
+            }
+
+            lock.lock();
+            state->error_ = error;
+            state->done_ = true;
+            state->cv_.notify_all();
+        }
+    }
+
+    void abandon()
+    {
+        if (state_)
+        {
+            lock_guard lock(state_->mutex_);
+            state_->quit_ = true;
+            state_->cv_.notify_all();
+        }
+        state_.reset();
+    }
+
+    shared_ptr<State> state_;
+
+};
+
+uint DesktopEntryIndexer::ParseCache::size() const { return entries_.size(); }
+
+pair<qint64, qint64> DesktopEntryIndexer::fileStamp(const QString &path)
+{
+    const QFileInfo fi(path);
+    return {fi.lastModified().toMSecsSinceEpoch(), fi.size()};
+}
+
+map<QString, QString> DesktopEntryIndexer::scan(const QStringList &directories,
+                                                Statistics *statistics,
+                                                const bool *abort)
+{
+    map<QString, QString> desktop_files;  // Desktop id > path
+    DirectoryWalk walk(abort);
+    uint shadowed = 0;
+
+    for (const QString &dir : directories)
+    {
+        if (abort && *abort)
+            break;
+
+        DEBG << "Scanning desktop entries in:" << dir;
+
+        walk.walk(dir, u".desktop"_s, [](const QString &){}, [&](const QString &path)
+        {
+            // To determine the ID of a desktop file, make its full path relative to
+            // the $XDG_DATA_DIRS component in which the desktop file is installed,
+            // remove the "applications/" prefix, and turn '/' into '-'. Chop off '.desktop'.
+            static QRegularExpression re(u"^.*applications/"_s);
+            QString id = QString(path).remove(re).replace(u'/', u'-').chopped(8);
+
+            if (const auto &[dit, success] = desktop_files.emplace(id, path); !success)
+            {
+                DEBG << u"Desktop file '%1' at '%2' will be skipped: Shadowed by '%3'"_s
+                            .arg(id, path, desktop_files[id]);
+                ++shadowed;
+            }
+        });
+    }
+
+    if (statistics)
+    {
+        statistics->shadowed = shadowed;
+        statistics->duplicates = walk.duplicates();
+    }
+
+    return desktop_files;
+}
+
+DesktopEntryIndexer::Result DesktopEntryIndexer::run(const QStringList &directories,
+                                                     Application::ParseOptions po,
+                                                     const bool &abort,
+                                                     const PrebuiltIndex *prebuilt,
+                                                     ParseCache *cache,
+                                                     const Limits &limits)
+{
+    Result r;
+    QElapsedTimer timer;
+    timer.start();
+
+    const auto desktop_files = scan(directories, &r.statistics, &abort);
+    r.statistics.desktop_files = desktop_files.size();
+    r.statistics.scan_ns = timer.nsecsElapsed();
+
+    // One directory listing per PATH entry instead of a stat per entry and PATH entry
+    const ExecutableIndex executables;
+    po.executables = &executables;
+
+    if (cache && (cache->locale_ != DesktopEntry::messagesLocale() || cache->flags_ != po.flags()
+                  || cache->executables_ != executables))
+    {
+        if (!cache->entries_.isEmpty())
+            DEBG << "Locale, parse options or executables changed. Invalidating parse cache.";
+        cache->locale_ = DesktopEntry::messagesLocale();
+        cache->flags_ = po.flags();
+        cache->executables_ = executables;
+        cache->entries_.clear();
+        ++cache->epoch_;
+    }
+
+    // Parse the unique desktop files
+    TimedWorker worker;
+    QHash<QString, ParseCache::Entry> parsed;
+    r.fingerprint = cache ? qHash(cache->epoch_) : 0;
+    for (const auto &[id, path] : desktop_files)
+    {
+        if (abort)
+            break;
+
+        const ParseCache::Entry *known = nullptr;  // Of previous runs
+        if (cache)
+            if (auto it = cache->entries_.constFind(path);
+                it != cache->entries_.cend() && it->id == id)
+                known = &*it;
+
+        // Beyond the time budget of the run, only entries known from previous runs are used
+        if (timer.elapsed() - r.statistics.scan_ns / 1'000'000 > limits.run_budget_ms)
+        {
+            if (!r.statistics.over_budget)
+                WARN << u"Index run exceeded its time budget of %1 ms."_s
+                            .arg(limits.run_budget_ms);
+            r.statistics.over_budget = true;
+
+            if (known)
+            {
+                if (known->application)
+                    r.applications.emplace_back(known->application);
+                ++r.statistics.cached;
+                parsed.insert(path, *known);
+            }
+            else
+                ++r.statistics.skip_reasons[u"Index run exceeded the time budget."_s];
+            continue;
+        }
+
+        QElapsedTimer file_timer;
+        file_timer.start();
+        const auto remaining_ms = [&]{ return limits.file_budget_ms - file_timer.elapsed(); };
+
+        // Stamp before reading, such that a file modified meanwhile is read again.
+        // Files and their stamps are accessed by the worker, whose blocking calls on hung
+        // mounts are abandoned once the file budget is exhausted.
+        const auto stamp = make_shared<pair<qint64, qint64>>();
+        const bool stamped = worker.run([stamp, path = path]{ *stamp = fileStamp(path); },
+                                        remaining_ms());
+        const auto [mtime, size] = stamped ? *stamp : pair<qint64, qint64>{};
+
+        ParseCache::Entry entry{.id = id, .mtime = mtime, .size = size, .hash = 0,
+                                .application = {}, .skip_reason = {}, .executable_checks = {}};
+
+        // Skipped entries are reused as well, which quarantines offending files until
+        // they are modified. Absolute TryExec and Exec executables are not covered by the
+        // stamp, hence checked again.
+        const ParseCache::Entry *cached = nullptr;
+        if (stamped && known && known->mtime == mtime && known->size == size
+            && executables.checksHold(known->executable_checks))
+            cached = known;
+
+        else try
+        {
+            if (!stamped)
+                throw runtime_error("Desktop file exceeded the time budget.");
+
+            // Checked by stamp, such that files covered by the prebuilt index are not read
+            if (entry.application = prebuilt ? prebuilt->load(path, *stamp, executables,
+                                                              &entry.hash)
+                                             : nullptr;
+                entry.application)
+                ++r.statistics.prebuilt;
+            else
+            {
+                const auto bytes = make_shared<QByteArray>();
+                if (!worker.run([bytes, path = path, max_size = limits.max_file_size]
+                                { *bytes = DesktopEntry::read(path, max_size); },
+                                remaining_ms()))
+                    throw runtime_error("Desktop file exceeded the time budget.");
+                entry.hash = qHash(*bytes, 0);
+
+                // E.g. touched by a package manager or rewritten by an editor
+                if (known && entry.hash == known->hash
+                    && executables.checksHold(known->executable_checks))
+                {
+                    cached = known;
+                    ++r.statistics.unchanged_content;
+                }
+                else
+                    entry.application = make_shared<Application>(id, path, *bytes, po);
+            }
+
+            if (!cached)
+            {
+                if (remaining_ms() < 0)
+                    throw runtime_error("Desktop file exceeded the time budget.");
+
+                DEBG << u"Valid desktop file '%1': '%2'"_s.arg(id, path);
+                r.applications.emplace_back(entry.application);
+            }
+        }
+        catch (const exception &e)
+        {
+            DEBG << u"Skipped desktop entry '%1':"_s.arg(path) << e.what();
+            ++r.statistics.skip_reasons[QString::fromLocal8Bit(e.what())];
+            entry.application.reset();
+            entry.skip_reason = e.what();
+        }
+
+        if (cached)
+        {
+            entry.hash = cached->hash;
+            entry.application = cached->application;
+            entry.skip_reason = cached->skip_reason;
+            entry.executable_checks = cached->executable_checks;
+            if (entry.application)
+                r.applications.emplace_back(entry.application);
+            else
+                ++r.statistics.skip_reasons[QString::fromLocal8Bit(entry.skip_reason.c_str())];
+            ++r.statistics.cached;
+        }
+        else
+            entry.executable_checks = executables.takeChecks();
+
+        if (cache)
+        {
+            // The access checks decide whether an entry is skipped
+            r.fingerprint = qHashMulti(r.fingerprint, id, path, entry.hash,
+                                       entry.application != nullptr);
+            parsed.insert(path, ::move(entry));
+        }
+    }
+
+    r.statistics.aborted = abort;
+
+    // An incomplete run keeps the entries of the previous runs, it has not seen all files
+    if (cache)
+    {
+        if (r.statistics.aborted || r.statistics.over_budget)
+        {
+            cache->entries_.insert(parsed);
+            r.fingerprint = 0;
+        }
+        else
+            cache->entries_ = ::move(parsed);
+    }
+
+    r.statistics.parse_ns = timer.nsecsElapsed() - r.statistics.scan_ns;
+    return r;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include "application.h"
+#include "executableindex.h"
+#include <QHash>
+#include <QStringList>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+class PrebuiltIndex;
+
+///
+/// The desktop entry discovery and parsing pipeline.
+///
+/// Independent of the plugin instance, such that it can be run headless.
+///
+class DesktopEntryIndexer
+{
+public:
+
+    /// Limits protecting the index run against pathological desktop files, e.g. huge
+    /// files, FIFOs or files on slow network mounts.
+    ///
+    /// Desktop files are accessed on a worker thread, which is abandoned if it exceeds the
+    /// file budget, e.g. blocking on a hung mount. The scan of the directories is not limited.
+    struct Limits
+    {
+        qint64 max_file_size = 1 << 20;  ///< Larger desktop files are skipped
+        qint64 file_budget_ms = 500;  ///< Files taking longer to read and parse are skipped
+        qint64 run_budget_ms = 10'000;  ///< Parse time of a run, excluding the scan
+    };
+
+    struct Statistics
+    {
+        uint desktop_files = 0;  ///< Unique desktop ids found
+        uint shadowed = 0;  ///< Desktop files shadowed by files with the same desktop id
+        uint duplicates = 0;  ///< Directories and files reached through several paths
+        uint prebuilt = 0;  ///< Applications loaded from the prebuilt index
+        uint cached = 0;  ///< Desktop entries reused from previous runs
+        uint unchanged_content = 0;  ///< Reused entries modified without content changes
+        bool aborted = false;
+        bool over_budget = false;  ///< Parsing exceeded Limits::run_budget_ms
+        std::map<QString, uint> skip_reasons;  ///< Skip reason > count
+        qint64 scan_ns = 0;
+        qint64 parse_ns = 0;
+    };
+
+    struct Result
+    {
+        std::vector<std::shared_ptr<Application>> applications;
+        Statistics statistics;
+
+        /// Hash of the desktop entries and the parse inputs. Equal fingerprints imply
+        /// equal results. 0 if not known, i.e. without cache or if aborted.
+        size_t fingerprint = 0;
+    };
+
+    ///
+    /// Parse results of previous runs.
+    ///
+    /// Reused for desktop files whose modification time and size or, failing that, content
+    /// hash did not change and whose absolute TryExec and Exec executables did not appear
+    /// or disappear, including the ones parsed by an aborted run, such that a
+    /// restarted run continues where the aborted one stopped. Invalidated as a whole if the
+    /// locale, the parse options or the executables changed. Not thread-safe, runs using
+    /// the same cache must not overlap.
+    ///
+    /// Skipped entries are cached as well, such that desktop files exceeding the limits
+    /// are not read again until they are modified.
+    ///
+    ///
+    class ParseCache
+    {
+    public:
+
+        uint size() const;
+
+    private:
+
+        friend class DesktopEntryIndexer;
+
+        struct Entry
+        {
+            QString id;
+            qint64 mtime;
+            qint64 size;
+            size_t hash;  // Of the content, or of the prebuilt entry if loaded from it
+            std::shared_ptr<Application> application;  // Null if skipped
+            std::string skip_reason;
+            ExecutableIndex::Checks executable_checks;  // TryExec and Exec
+        };
+
+        QString locale_;
+        quint8 flags_ = 0;
+        std::optional<ExecutableIndex> executables_;
+        quint64 epoch_ = 0;  // Incremented on invalidation
+        QHash<QString, Entry> entries_;  // Path > entry
+
+    };
+
+    /// Returns the modification time in ms since epoch and the size of the file at _path_.
+    static std::pair<qint64, qint64> fileStamp(const QString &path);
+
+    /// Returns the unique desktop entries in _directories_ (desktop id > path).
+    /// Entries in earlier directories shadow entries with the same id in later ones.
+    /// Files reachable through several paths are returned once. Sets the scan counters of
+    /// _statistics_, if not null. Returns early if _abort_ is set.
+    static std::map<QString, QString> scan(const QStringList &directories,
+                                           Statistics *statistics = nullptr,
+                                           const bool *abort = nullptr);
+
+    /// Scans _directories_ and parses the desktop entries using _po_.
+    /// The executables member of _po_ is set by the indexer.
+    /// Up-to-date entries of _prebuilt_ and _cache_ are loaded instead of being parsed.
+    /// Desktop files are read within _limits_. Once the run budget is
+    /// exhausted, only entries known to _cache_ are used. The result of an aborted or over
+    /// budget run is incomplete, see Statistics::aborted and Statistics::over_budget.
+    static Result run(const QStringList &directories,
+                      Application::ParseOptions po,
+                      const bool &abort,
+                      const PrebuiltIndex *prebuilt = nullptr,
+                      ParseCache *cache = nullptr,
+                      const Limits &limits = {});
+
+};
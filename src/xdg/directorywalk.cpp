@@ -0,0 +1,108 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "directorywalk.h"
+#include <QFile>
+#include <albert/logging.h>
+#include <dirent.h>
+#include <sys/stat.h>
+using namespace std;
+
+DirectoryWalk::DirectoryWalk(const bool *abort, uint max_depth):
+    abort_(abort),
+    max_depth_(max_depth)
+{}
+
+void DirectoryWalk::walk(const QString &root,
+                         const QString &suffix,
+                         const function<void(const QString &)> &on_directory,
+                         const function<void(const QString &)> &on_file)
+{
+    struct stat st;
+    if (::stat(QFile::encodeName(root).constData(), &st) != 0 || !S_ISDIR(st.st_mode))
+        return;
+
+    if (!visited_.emplace(st.st_dev, st.st_ino).second)
+    {
+        ++duplicates_;
+        return;
+    }
+
+    suffix_ = suffix;
+    on_directory_ = &on_directory;
+    on_file_ = &on_file;
+
+    (*on_directory_)(root);
+    walk(root, 0);
+}
+
+uint DirectoryWalk::duplicates() const { return duplicates_; }
+
+void DirectoryWalk::walk(const QString &dir, uint depth)
+{
+    DIR *d = opendir(QFile::encodeName(dir).constData());
+    if (!d)
+        return;
+
+    struct stat dir_st;
+    if (fstat(dirfd(d), &dir_st) != 0)
+    {
+        closedir(d);
+        return;
+    }
+
+    while (const dirent *e = readdir(d))
+    {
+        if (abort_ && *abort_)
+            break;
+
+        if (e->d_name[0] == '.')  // Includes '.' and '..'
+            continue;  // Hidden
+
+        const auto path = dir + u'/' + QFile::decodeName(e->d_name);
+
+        // Regular files are identified by the directory entry. Directories can be mount
+        // points and symlinks have to be resolved, both need a stat.
+        bool is_dir;
+        pair<dev_t, ino_t> id;
+        if (e->d_type == DT_REG)
+        {
+            if (!path.endsWith(suffix_))
+                continue;
+            is_dir = false;
+            id = {dir_st.st_dev, e->d_ino};
+        }
+        else if (e->d_type == DT_DIR || e->d_type == DT_LNK || e->d_type == DT_UNKNOWN)
+        {
+            struct stat st;
+            if (fstatat(dirfd(d), e->d_name, &st, 0) != 0)
+                continue;  // E.g. dangling symlink
+
+            if (S_ISDIR(st.st_mode))
+                is_dir = true;
+            else if (S_ISREG(st.st_mode) && path.endsWith(suffix_))
+                is_dir = false;
+            else
+                continue;
+            id = {st.st_dev, st.st_ino};
+        }
+        else
+            continue;
+
+        if (!visited_.insert(id).second)
+        {
+            DEBG << "Skipping duplicate:" << path;
+            ++duplicates_;
+        }
+        else if (!is_dir)
+            (*on_file_)(path);
+        else if (depth + 1 > max_depth_)
+            WARN << "Maximum directory depth exceeded:" << path;
+        else
+        {
+            (*on_directory_)(path);
+            walk(path, depth + 1);
+        }
+    }
+
+    closedir(d);
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QString>
+#include <functional>
+#include <set>
+#include <sys/types.h>
+
+///
+/// Recursive directory walk following symlinks.
+///
+/// Tracks the visited (device, inode) pairs, hence every physical directory and file is
+/// visited once, no matter through how many paths it is reachable, and symlink cycles
+/// terminate. The visited set is shared by subsequent walks of the same instance, such that
+/// trees reachable from several roots are visited once too. The depth is bounded.
+///
+/// If an abort flag is given, the walk stops after the directory entry being processed
+/// once the flag is set.
+///
+class DirectoryWalk
+{
+public:
+
+    static constexpr uint default_max_depth = 16;
+
+    explicit DirectoryWalk(const bool *abort = nullptr, uint max_depth = default_max_depth);
+
+    /// Walks _root_. Calls _on_directory_ for every directory including _root_ and
+    /// _on_file_ for every regular file whose name ends with _suffix_.
+    void walk(const QString &root,
+              const QString &suffix,
+              const std::function<void(const QString &path)> &on_directory,
+              const std::function<void(const QString &path)> &on_file);
+
+    /// The number of directories and files skipped, since they have been visited before.
+    uint duplicates() const;
+
+private:
+
+    void walk(const QString &dir, uint depth);
+
+    const bool *abort_;
+    const uint max_depth_;
+    QString suffix_;
+    const std::function<void(const QString &)> *on_directory_ = nullptr;
+    const std::function<void(const QString &)> *on_file_ = nullptr;
+    std::set<std::pair<dev_t, ino_t>> visited_;
+    uint duplicates_ = 0;
+
+};
@@ -0,0 +1,41 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "executableindex.h"
+#include <QFile>
+#include <dirent.h>
+#include <algorithm>
+#include <unistd.h>
+using namespace Qt::StringLiterals;
+using namespace std;
+
+static bool isExecutable(const QString &path)
+{ return access(QFile::encodeName(path).constData(), X_OK) == 0; }
+
+ExecutableIndex::ExecutableIndex(const QStringList &directories)
+{
+    for (const auto &dir : directories)
+        if (DIR *d = opendir(QFile::encodeName(dir).constData()); d)
+        {
+            while (const dirent *e = readdir(d))
+                if (e->d_type != DT_DIR && e->d_name[0] != '.')
+                    names_.insert(QFile::decodeName(e->d_name));
+            closedir(d);
+        }
+}
+
+bool ExecutableIndex::check(const QString &command) const
+{ return command.contains(u'/') ? isExecutable(command) : names_.contains(command); }
+
+bool ExecutableIndex::contains(const QString &command) const
+{ return checks_.emplace_back(command, check(command)).second; }
+
+bool ExecutableIndex::operator==(const ExecutableIndex &other) const
+{ return names_ == other.names_; }
+
+ExecutableIndex::Checks ExecutableIndex::takeChecks() const { return exchange(checks_, {}); }
+
+bool ExecutableIndex::checksHold(const Checks &checks) const
+{ return ranges::all_of(checks, [this](const auto &c){ return check(c.first) == c.second; }); }
+
+QStringList ExecutableIndex::pathDirectories()
+{ return qEnvironmentVariable("PATH").split(u':', Qt::SkipEmptyParts); }
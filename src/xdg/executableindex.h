@@ -0,0 +1,52 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <utility>
+#include <vector>
+
+///
+/// Set of the command names available in a list of directories, usually $PATH.
+///
+/// Built from one directory listing per directory. Entries are not stat'ed, hence a
+/// non-executable file in a PATH directory is considered executable.
+///
+/// The checks are recorded, such that results depending on them can be revalidated, e.g.
+/// the ones of absolute commands, which are not covered by the listings. Not thread-safe.
+///
+class ExecutableIndex
+{
+public:
+
+    /// Checked commands and the results of the checks.
+    using Checks = std::vector<std::pair<QString, bool>>;
+
+    /// Lists the _directories_.
+    explicit ExecutableIndex(const QStringList &directories = pathDirectories());
+
+    /// Returns true if _command_ is an executable.
+    /// Commands containing a slash are checked using access(2).
+    bool contains(const QString &command) const;
+
+    /// Returns true if the directory listings are equal.
+    bool operator==(const ExecutableIndex &other) const;
+
+    /// Returns the checks made by contains() since the last call.
+    Checks takeChecks() const;
+
+    /// Returns true if the _checks_ have the same results using this index. Not recorded.
+    bool checksHold(const Checks &checks) const;
+
+    /// Returns the directories in $PATH.
+    static QStringList pathDirectories();
+
+private:
+
+    QSet<QString> names_;
+    bool check(const QString &command) const;
+
+    mutable Checks checks_;
+
+};
@@ -0,0 +1,13 @@
+// Copyright (c) 2026 Manuel Schneider
+
+// Replaces applicationactions.cpp in the headless tools, which parse desktop entries without
+// a plugin instance and never launch them. The vtable emitted with application.cpp needs
+// definitions of the plugin dependent overrides.
+
+#include "application.h"
+using namespace albert;
+using namespace std;
+
+void Application::launch() const {}
+
+vector<Action> Application::actions() const { return {}; }
@@ -0,0 +1,202 @@
+// Copyright (c) 2026 Manuel Schneider
+
+// Headless driver of the desktop entry indexer for profiling and regression tracking.
+
+#include "desktopentryindexer.h"
+#include "prebuiltindex.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <albert/logging.h>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+ALBERT_LOGGING_CATEGORY("apps")
+using namespace Qt::StringLiterals;
+using namespace std;
+
+static void evictFromPageCache(const QStringList &directories)
+{
+    // Dropping the dentry and inode caches requires root
+    if (QFile f(u"/proc/sys/vm/drop_caches"_s); f.open(QIODevice::WriteOnly))
+    {
+        sync();
+        f.write("3");
+        return;
+    }
+
+    for (const auto &[id, path] : DesktopEntryIndexer::scan(directories))
+        if (const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+            fd >= 0)
+        {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+}
+
+static double ms(qint64 ns) { return ns / 1e6; }
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(u"applications-index-driver"_s);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(u"Runs the desktop entry indexer of the applications "
+                                     "plugin without albert and prints timings and counts."_s);
+    parser.addHelpOption();
+
+    const QCommandLineOption opt_data_dirs(
+        {u"d"_s, u"data-dirs"_s},
+        u"Colon separated XDG data directories to index. Defaults to the XDG base directories."_s,
+        u"dirs"_s);
+    const QCommandLineOption opt_repeat(
+        {u"r"_s, u"repeat"_s}, u"Number of timed runs."_s, u"n"_s, u"1"_s);
+    const QCommandLineOption opt_mode(
+        {u"m"_s, u"mode"_s},
+        u"Cache mode. 'default': no preparation, 'warm': untimed run before the timed runs, "
+        "'cold': evict the desktop files from the page cache before each run."_s,
+        u"mode"_s, u"default"_s);
+    const QCommandLineOption opt_verbose(
+        {u"v"_s, u"verbose"_s}, u"Print debug output, e.g. the reason for each skipped entry."_s);
+    const QCommandLineOption opt_hide_missing_executables(
+        u"hide-missing-executables"_s, u"Skip entries whose Exec executable is missing."_s);
+    const QCommandLineOption opt_respect_show_in_keys(
+        u"respect-show-in-keys"_s, u"Respect 'OnlyShowIn'/'NotShowIn'."_s);
+    const QCommandLineOption opt_use_exec(u"use-exec"_s, u"Use 'Exec'."_s);
+    const QCommandLineOption opt_use_generic_name(u"use-generic-name"_s, u"Use 'GenericName'."_s);
+    const QCommandLineOption opt_use_keywords(u"use-keywords"_s, u"Use 'Keywords'."_s);
+    const QCommandLineOption opt_use_non_localized_name(
+        u"use-non-localized-name"_s, u"Use the non-localized name."_s);
+    const QCommandLineOption opt_write_index(
+        u"write-index"_s,
+        u"Write a prebuilt index of the data directories to _file_ and exit. Defaults to the "
+        "system data directories, i.e. excludes the user data directory."_s,
+        u"file"_s);
+    const QCommandLineOption opt_prebuilt_index(
+        u"prebuilt-index"_s, u"Load up-to-date entries from the prebuilt index _file_."_s,
+        u"file"_s);
+
+    parser.addOptions({opt_data_dirs, opt_repeat, opt_mode, opt_verbose,
+                       opt_hide_missing_executables, opt_respect_show_in_keys, opt_use_exec,
+                       opt_use_generic_name, opt_use_keywords, opt_use_non_localized_name,
+                       opt_write_index, opt_prebuilt_index});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    bool ok;
+    const auto repeat = parser.value(opt_repeat).toUInt(&ok);
+    const auto mode = parser.value(opt_mode);
+    if (!ok || repeat == 0 || !QStringList{u"default"_s, u"warm"_s, u"cold"_s}.contains(mode))
+    {
+        err << "Invalid arguments.\n";
+        parser.showHelp(1);
+    }
+
+    if (parser.isSet(opt_verbose))
+        QLoggingCategory::setFilterRules(u"*.debug=true"_s);
+
+    QStringList directories;
+    if (parser.isSet(opt_data_dirs))
+        for (const auto &dir : parser.value(opt_data_dirs).split(u':', Qt::SkipEmptyParts))
+            directories << QDir(dir).filePath(u"applications"_s);
+    else
+    {
+        directories = QStandardPaths::standardLocations(QStandardPaths::ApplicationsLocation);
+        if (parser.isSet(opt_write_index))
+            directories.removeAll(
+                QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation));
+    }
+
+    const Application::ParseOptions po{
+        .hide_missing_executables = parser.isSet(opt_hide_missing_executables),
+        .ignore_show_in_keys = !parser.isSet(opt_respect_show_in_keys),
+        .use_exec = parser.isSet(opt_use_exec),
+        .use_generic_name = parser.isSet(opt_use_generic_name),
+        .use_keywords = parser.isSet(opt_use_keywords),
+        .use_non_localized_name = parser.isSet(opt_use_non_localized_name),
+        .executables = nullptr
+    };
+
+    out << "Directories: " << directories.join(u':') << "\n";
+
+    if (parser.isSet(opt_write_index))
+    {
+        try {
+            const auto count = PrebuiltIndex::write(parser.value(opt_write_index),
+                                                    DesktopEntryIndexer::scan(directories), po);
+            out << "Wrote " << count << " entries to " << parser.value(opt_write_index) << "\n";
+            return 0;
+        } catch (const exception &e) {
+            err << "Failed to write prebuilt index: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    out << "Mode: " << mode << ", runs: " << repeat << "\n";
+
+    unique_ptr<PrebuiltIndex> prebuilt;
+    if (parser.isSet(opt_prebuilt_index))
+    {
+        prebuilt = make_unique<PrebuiltIndex>(parser.value(opt_prebuilt_index), po);
+        if (!prebuilt->isValid())
+        {
+            err << "Invalid prebuilt index.\n";
+            return 1;
+        }
+    }
+
+    const bool abort = false;
+    if (mode == u"warm"_s)
+        DesktopEntryIndexer::run(directories, po, abort, prebuilt.get());
+
+    vector<qint64> totals;
+    DesktopEntryIndexer::Result r;
+    for (uint i = 0; i < repeat; ++i)
+    {
+        if (mode == u"cold"_s)
+            evictFromPageCache(directories);
+
+        r = DesktopEntryIndexer::run(directories, po, abort, prebuilt.get());
+        const auto &s = r.statistics;
+        totals.push_back(s.scan_ns + s.parse_ns);
+
+        out << u"Run %1: scan %2 ms, parse %3 ms, total %4 ms\n"_s
+                   .arg(i + 1)
+                   .arg(ms(s.scan_ns), 0, 'f', 2)
+                   .arg(ms(s.parse_ns), 0, 'f', 2)
+                   .arg(ms(totals.back()), 0, 'f', 2);
+        out.flush();
+    }
+
+    const auto &s = r.statistics;
+    uint skipped = 0;
+    for (const auto &[reason, count] : s.skip_reasons)
+        skipped += count;
+
+    out << "Desktop files: " << s.desktop_files << "\n"
+        << "Shadowed: " << s.shadowed << "\n"
+        << "Duplicates: " << s.duplicates << "\n"
+        << "Prebuilt: " << s.prebuilt << "\n"
+        << "Applications: " << r.applications.size() << "\n"
+        << "Terminal emulators: "
+        << ranges::count_if(r.applications, [](const auto &a){ return a->isTerminal(); }) << "\n"
+        << "Skipped: " << skipped << "\n";
+
+    for (const auto &[reason, count] : s.skip_reasons)
+        out << "  " << count << "\t" << reason << "\n";
+
+    ranges::sort(totals);
+    out << u"Total min/median/max: %1/%2/%3 ms\n"_s
+               .arg(ms(totals.front()), 0, 'f', 2)
+               .arg(ms(totals[totals.size() / 2]), 0, 'f', 2)
+               .arg(ms(totals.back()), 0, 'f', 2);
+
+    return 0;
+}
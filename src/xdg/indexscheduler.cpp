@@ -0,0 +1,131 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "indexscheduler.h"
+#include <QFile>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <albert/logging.h>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <sys/syscall.h>
+#endif
+using namespace Qt::StringLiterals;
+using namespace std;
+
+static void setIdleIoPriority()
+{
+#if defined(Q_OS_LINUX)
+    // linux/ioprio.h is not available on all distributions
+    constexpr int ioprio_who_process = 1;
+    constexpr int ioprio_class_idle = 3;
+    constexpr int ioprio_class_shift = 13;
+    if (syscall(SYS_ioprio_set, ioprio_who_process, 0, ioprio_class_idle << ioprio_class_shift))
+        DEBG << "Failed to set idle I/O priority:" << strerror(errno);
+#endif
+}
+
+struct IndexScheduler::IdleThread
+{
+    mutex mutex_;
+    bool shut_down_ = false;
+    QThreadPool pool_;
+};
+
+IndexScheduler::IndexScheduler(function<void()> run, Options options):
+    run_(::move(run)),
+    options_(options),
+    idle_(make_shared<IdleThread>())
+{
+    timer_.setSingleShot(true);
+    QObject::connect(&timer_, &QTimer::timeout, &timer_, [this]{ onTimeout(); });
+
+    // The scheduling policy of a thread can not be raised again without privileges,
+    // hence a dedicated thread instead of lowering the one of the caller temporarily.
+    // Maps to SCHED_IDLE on Linux.
+    idle_->pool_.setMaxThreadCount(1);
+    idle_->pool_.setThreadPriority(QThread::IdlePriority);
+}
+
+IndexScheduler::~IndexScheduler()
+{
+    {
+        lock_guard lock(idle_->mutex_);
+        idle_->shut_down_ = true;
+    }
+    idle_->pool_.waitForDone();
+}
+
+void IndexScheduler::request(bool urgent)
+{
+    if (urgent)
+    {
+        timer_.stop();
+        pending_.invalidate();
+        run_();
+        return;
+    }
+
+    if (!pending_.isValid())
+        pending_.start();
+
+    // Past the deadline a continuous stream of requests must not postpone the run further
+    if (!timer_.isActive() || pending_.elapsed() < options_.max_staleness_ms)
+        timer_.start(options_.debounce_ms);
+}
+
+function<void(const function<void()> &)> IndexScheduler::idleRunner() const
+{
+    // Shares the thread, such that callers, e.g. executor threads outliving the scheduler,
+    // never touch the destroyed scheduler
+    return [idle = idle_](const function<void()> &work)
+    {
+        QFuture<void> future;
+        {
+            lock_guard lock(idle->mutex_);
+            if (idle->shut_down_)
+                return;
+            future = QtConcurrent::run(&idle->pool_, [&]{ setIdleIoPriority(); work(); });
+        }
+        future.waitForFinished();
+    };
+}
+
+uint IndexScheduler::deferrals() const { return deferrals_; }
+
+optional<double> IndexScheduler::pressure(const char *resource)
+{
+#if defined(Q_OS_LINUX)
+    // E.g. "some avg10=1.23 avg60=0.87 avg300=0.41 total=12345678"
+    if (QFile f(u"/proc/pressure/"_s + QLatin1StringView(resource));
+        f.open(QIODevice::ReadOnly | QIODevice::Text))
+        for (const auto &field : f.readLine().trimmed().split(' '))
+            if (field.startsWith("avg10="))
+                if (bool ok; const auto value = field.mid(6).toDouble(&ok); ok)
+                    return value;
+#else
+    Q_UNUSED(resource)
+#endif
+    return {};
+}
+
+void IndexScheduler::onTimeout()
+{
+    if (const auto remaining = options_.max_staleness_ms - pending_.elapsed(); remaining > 0)
+    {
+        const auto cpu = pressure("cpu").value_or(0.);
+        const auto io = pressure("io").value_or(0.);
+        if (max(cpu, io) > options_.pressure_threshold)
+        {
+            DEBG << u"Deferring index run. Pressure: cpu %1%, io %2%."_s.arg(cpu).arg(io);
+            ++deferrals_;
+            timer_.start(static_cast<int>(min<qint64>(options_.retry_ms, remaining)));
+            return;
+        }
+    }
+
+    pending_.invalidate();
+    run_();
+}
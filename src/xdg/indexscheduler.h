@@ -0,0 +1,64 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QElapsedTimer>
+#include <QTimer>
+#include <functional>
+#include <memory>
+#include <optional>
+
+///
+/// Load-aware scheduling of index runs.
+///
+/// Urgent requests run immediately. Other requests are debounced and deferred while the CPU
+/// or I/O pressure stall information (PSI, Linux only) exceeds a threshold, but at most until
+/// the oldest pending request reached the maximum staleness.
+///
+/// Index runs are executed on a dedicated thread with idle CPU and I/O priority.
+///
+class IndexScheduler
+{
+public:
+
+    struct Options
+    {
+        int debounce_ms = 1'000;  ///< Quiet period after the last request
+        int retry_ms = 5'000;  ///< Interval of the pressure checks while deferred
+        qint64 max_staleness_ms = 60'000;  ///< Deadline of the oldest pending request
+        double pressure_threshold = 10.;  ///< Stall percentage of the last 10 s
+    };
+
+    /// Schedules _run_, which is called in the thread of the scheduler.
+    explicit IndexScheduler(std::function<void()> run, Options options = {});
+    ~IndexScheduler();
+
+    /// Requests a call of the run function.
+    void request(bool urgent);
+
+    /// Returns a function which runs its argument on the idle priority thread and blocks until
+    /// it returned. The function may outlive the scheduler. Once the destruction of the
+    /// scheduler started, it returns without running its argument, while the destructor waits
+    /// for the work in flight.
+    std::function<void(const std::function<void()> &)> idleRunner() const;
+
+    /// The number of times a pending run has been deferred due to pressure.
+    uint deferrals() const;
+
+    /// Returns the percentage of the last 10 s some tasks stalled on _resource_, i.e.
+    /// "cpu", "io" or "memory". Empty if pressure stall information is not available.
+    static std::optional<double> pressure(const char *resource);
+
+private:
+
+    void onTimeout();
+
+    struct IdleThread;
+
+    std::function<void()> run_;
+    const Options options_;
+    QTimer timer_;
+    QElapsedTimer pending_;  // Since the oldest pending request, invalid if none
+    std::shared_ptr<IdleThread> idle_;
+    uint deferrals_ = 0;
+
+};
@@ -0,0 +1,233 @@
+// Copyright (c) 2026 Manuel Schneider
+
+// Churn stress harness for the indexer. Mutates a synthetic applications tree while a file
+// system watcher triggers index runs through the scheduler, executor, idle thread and parse
+// cache used by the plugin, then measures how the indexer copes.
+
+#include "desktopentryindexer.h"
+#include "indexscheduler.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+#include <albert/backgroundexecutor.h>
+#include <albert/logging.h>
+#include <atomic>
+#include <sys/resource.h>
+ALBERT_LOGGING_CATEGORY("apps")
+using namespace Qt::StringLiterals;
+using namespace std;
+
+// Counts the index generations alive at the same time
+static atomic_uint live_generations = 0;
+static atomic_uint peak_generations = 0;
+
+using Generation = shared_ptr<DesktopEntryIndexer::Result>;
+
+static Generation makeGeneration(DesktopEntryIndexer::Result &&r)
+{
+    const auto live = ++live_generations;
+    for (auto peak = peak_generations.load(); live > peak;)
+        if (peak_generations.compare_exchange_weak(peak, live))
+            break;
+
+    return Generation(new DesktopEntryIndexer::Result(::move(r)),
+                      [](DesktopEntryIndexer::Result *p){ --live_generations; delete p; });
+}
+
+class Tree
+{
+public:
+
+    explicit Tree(const QString &dir) : dir_(dir) {}
+
+    void write(uint n, uint revision)
+    {
+        const auto name = u"App %1 revision %2"_s.arg(n).arg(revision);
+        const auto path = dir_.filePath(u"stress-%1.desktop"_s.arg(n));
+
+        // Package managers write temporary files and rename them
+        QFile f(path + u".tmp"_s);
+        if (!f.open(QIODevice::WriteOnly))
+            qFatal("Failed to write %s", qPrintable(f.fileName()));
+        f.write(u"[Desktop Entry]\nType=Application\nName=%1\nExec=true\n"_s.arg(name).toUtf8());
+        f.close();
+        QFile::remove(path);
+        f.rename(path);
+
+        expected_[u"stress-%1"_s.arg(n)] = name;
+    }
+
+    void remove(uint n)
+    {
+        QFile::remove(dir_.filePath(u"stress-%1.desktop"_s.arg(n)));
+        expected_.erase(u"stress-%1"_s.arg(n));
+    }
+
+    void mutate(uint files)
+    {
+        const auto n = QRandomGenerator::global()->bounded(files);
+        if (expected_.contains(u"stress-%1"_s.arg(n)) && QRandomGenerator::global()->bounded(4) == 0)
+            remove(n);
+        else
+            write(n, ++revision_);
+    }
+
+    bool matches(const vector<shared_ptr<Application>> &apps) const
+    {
+        if (apps.size() != expected_.size())
+            return false;
+        for (const auto &app : apps)
+            if (auto it = expected_.find(app->id()); it == expected_.end() || it->second != app->name())
+                return false;
+        return true;
+    }
+
+private:
+
+    QDir dir_;
+    map<QString, QString> expected_;  // Desktop id > name
+    uint revision_ = 0;
+
+};
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(u"applications-index-stress"_s);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(u"Mutates a synthetic applications tree while a file "
+                                     "system watcher triggers index runs."_s);
+    parser.addHelpOption();
+
+    const QCommandLineOption opt_files(
+        {u"f"_s, u"files"_s}, u"Number of desktop files."_s, u"n"_s, u"400"_s);
+    const QCommandLineOption opt_rate(
+        {u"r"_s, u"rate"_s}, u"Mutations per second."_s, u"n"_s, u"200"_s);
+    const QCommandLineOption opt_duration(
+        {u"d"_s, u"duration"_s}, u"Duration of the storm in seconds."_s, u"s"_s, u"5"_s);
+    const QCommandLineOption opt_timeout(
+        {u"t"_s, u"timeout"_s}, u"Maximum time to consistency in seconds. Includes the "
+                                "deferrals of the scheduler under pressure."_s, u"s"_s, u"90"_s);
+
+    parser.addOptions({opt_files, opt_rate, opt_duration, opt_timeout});
+    parser.process(app);
+
+    const auto files = max(1u, parser.value(opt_files).toUInt());
+    const auto rate = max(1u, parser.value(opt_rate).toUInt());
+    const auto duration_ms = parser.value(opt_duration).toUInt() * 1000;
+    const auto timeout_ms = parser.value(opt_timeout).toUInt() * 1000;
+
+    QTemporaryDir tmp;
+    const auto dir = QDir(tmp.path()).filePath(u"applications"_s);
+    QDir().mkpath(dir);
+
+    Tree tree(dir);
+    for (uint i = 0; i < files; ++i)
+        tree.write(i, 0);
+
+    const Application::ParseOptions po{
+        .hide_missing_executables = false,
+        .ignore_show_in_keys = true,
+        .use_exec = false,
+        .use_generic_name = false,
+        .use_keywords = false,
+        .use_non_localized_name = false,
+        .executables = nullptr
+    };
+
+    atomic_uint scans = 0;
+    atomic_uint aborted = 0;
+    atomic<qint64> wasted_ns = 0;
+    uint generations = 0;
+    qint64 time_to_consistency_ms = -1;
+    bool storm = true;
+
+    QElapsedTimer since_storm;
+    QTextStream out(stdout);
+
+    // Wired like in the plugin. Declared before the scheduler, which has to be destroyed
+    // first, since it waits for the run in flight.
+    albert::BackgroundExecutor<Generation> indexer;
+    DesktopEntryIndexer::ParseCache parse_cache;  // Used by the idle thread only
+    IndexScheduler scheduler([&]{ indexer.run(); });
+
+    indexer.parallel = [&, run_idle = scheduler.idleRunner()](const bool &abort)
+    {
+        Generation generation;
+        run_idle([&]
+        {
+            ++scans;
+            auto r = DesktopEntryIndexer::run({dir}, po, abort, nullptr, &parse_cache);
+            if (abort)
+            {
+                ++aborted;
+                wasted_ns += r.statistics.scan_ns + r.statistics.parse_ns;
+            }
+            generation = makeGeneration(::move(r));
+        });
+        return generation;
+    };
+
+    indexer.finish = [&]
+    {
+        auto generation = indexer.takeResult();
+        ++generations;
+
+        if (!storm && tree.matches(generation->applications))
+        {
+            time_to_consistency_ms = since_storm.elapsed();
+            QCoreApplication::quit();
+        }
+    };
+
+    QFileSystemWatcher watcher({dir});
+    QObject::connect(&watcher, &QFileSystemWatcher::directoryChanged,
+                     &app, [&]{ scheduler.request(false); });
+
+    QTimer mutator;
+    mutator.setInterval(max(1u, 1000 / rate));
+    QObject::connect(&mutator, &QTimer::timeout, &app, [&]{ tree.mutate(files); });
+
+    QTimer::singleShot(duration_ms, &app, [&]
+    {
+        mutator.stop();
+        storm = false;
+        since_storm.start();
+        scheduler.request(false);  // The last mutation may have been indexed already
+    });
+
+    QTimer::singleShot(duration_ms + timeout_ms, &app, &QCoreApplication::quit);
+
+    indexer.run();
+    mutator.start();
+    app.exec();
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    out << "Files: " << files << ", rate: " << rate << "/s, storm: " << duration_ms << " ms\n"
+        << "Scans: " << scans << "\n"
+        << "Deferrals: " << scheduler.deferrals() << "\n"
+        << "Aborted scans: " << aborted << "\n"
+        << u"Wasted work: %1 ms\n"_s.arg(wasted_ns / 1e6, 0, 'f', 1)
+        << "Published generations: " << generations << "\n"
+        << "Peak overlapping generations: " << peak_generations << "\n"
+        << "Peak RSS: " << usage.ru_maxrss / 1024 << " MiB\n";
+
+    if (time_to_consistency_ms < 0)
+    {
+        out << "Not consistent after " << timeout_ms << " ms\n";
+        return 1;
+    }
+
+    out << "Time to consistency: " << time_to_consistency_ms << " ms\n";
+    return 0;
+}
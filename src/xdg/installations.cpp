@@ -0,0 +1,188 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "application.h"
+#include "installations.h"
+#include <QFileInfo>
+#include <QHash>
+#include <QProcess>
+#include <QRegularExpression>
+#include <albert/logging.h>
+#include <algorithm>
+#include <map>
+using namespace Qt::StringLiterals;
+using namespace std;
+
+static const uint max_wrapper_depth = 4;  // E.g. env in sh -c
+
+// env [OPTION]... [NAME=VALUE]... [COMMAND [ARG]...]
+static QStringList unwrapEnv(const QStringList &argv)
+{
+    qsizetype i = 1;
+    while (i < argv.size())
+    {
+        const auto &arg = argv[i];
+        if (arg == u"-u"_s || arg == u"-C"_s)  // Options taking a value
+            i += 2;
+        else if (arg == u"--"_s)
+        {
+            ++i;
+            break;
+        }
+        else if (arg.startsWith(u'-') || arg.contains(u'='))
+            ++i;
+        else
+            break;
+    }
+    return argv.mid(i);
+}
+
+// Name[-Version][-Arch].AppImage
+static QString appImageName(const QString &file_name)
+{
+    static const QRegularExpression re(
+        uR"(([-_ ]v?\d[^-_ ]*)?([-_](x86_64|amd64|aarch64|arm64|armhf|i386|i686))?\.appimage$)"_s,
+        QRegularExpression::CaseInsensitiveOption);
+    return QString(file_name).remove(re).toLower();
+}
+
+WrappedCommand::WrappedCommand(const QStringList &exec)
+{
+    QStringList argv = exec;
+    for (uint depth = 0; depth < max_wrapper_depth && !argv.isEmpty(); ++depth)
+    {
+        static const QStringList shells{u"sh"_s, u"bash"_s, u"dash"_s, u"zsh"_s};
+        const auto name = QFileInfo(argv.first()).fileName();
+
+        if (name == u"env"_s)
+            argv = unwrapEnv(argv);
+
+        else if (shells.contains(name) && argv.size() > 2 && argv[1] == u"-c"_s)
+        {
+            argv = QProcess::splitCommand(argv[2]);
+            if (!argv.isEmpty() && argv.first() == u"exec"_s)
+                argv.removeFirst();
+        }
+
+        else
+            break;
+    }
+
+    if (argv.isEmpty())
+        return;
+
+    program = argv.first();
+    const auto name = QFileInfo(argv.first()).fileName();
+
+    // flatpak run [OPTION]... APP [ARG]...
+    if (name == u"flatpak"_s)
+    {
+        source = PackageSource::Flatpak;
+        for (const auto &arg : argv.mid(1))
+            if (arg.startsWith(u"--command="_s))
+                command = arg.mid(10);  // size of '--command='
+            else if (flatpak_id.isEmpty() && !arg.startsWith(u'-') && arg != u"run"_s)
+                flatpak_id = arg;
+
+        // The command of the app is not known, the last component of its id is a guess
+        if (command.isEmpty())
+        {
+            DEBG << "Flatpak exec commandline w/o '--command':" << exec.join(QChar::Space);
+            command = flatpak_id.section(u'.', -1).toLower();
+            guessed = true;
+        }
+    }
+
+    // Snapcraft
+    else if (auto it = ranges::find_if(argv, [](const auto &arg)
+                                       { return arg.startsWith(u"/snap/bin/"_s); });
+             it != argv.end())
+    {
+        source = PackageSource::Snap;
+        if (command = it->mid(10); command.isEmpty())  // size of '/snap/bin/'
+            WARN << "Failed getting snap command: Exec:" << exec.join(QChar::Space);
+    }
+
+    else if (name.endsWith(u".appimage"_s, Qt::CaseInsensitive))
+    {
+        source = PackageSource::AppImage;
+        command = appImageName(name);
+    }
+
+    // Native command
+    else
+        command = name;
+}
+
+Installations::Installations(const vector<shared_ptr<applications::Application>> &applications,
+                             PackageSource preferred)
+{
+    auto rank = [preferred](PackageSource s)
+    { return s == preferred ? -1 : int(ranges::find(sources, s) - begin(sources)); };
+
+    map<QString, vector<pair<shared_ptr<Application>, PackageSource>>> by_command;  // Case folded
+    QHash<QString, QString> command_by_id;
+    vector<pair<shared_ptr<Application>, QString>> guessed;  // App > Flatpak id
+    for (const auto &iapp : applications)
+    {
+        auto app = static_pointer_cast<Application>(iapp);
+        if (WrappedCommand w(app->exec()); w.command.isEmpty())
+            continue;
+        else if (w.guessed)
+            guessed.emplace_back(::move(app), ::move(w.flatpak_id));
+        else
+        {
+            const auto command = w.command.toCaseFolded();
+            command_by_id.insert(app->id(), command);
+            by_command[command].emplace_back(::move(app), w.source);
+        }
+    }
+
+    // A guessed command may be the one of an unrelated application, e.g. 'terminal'
+    for (auto &[app, flatpak_id] : guessed)
+        if (auto it = command_by_id.constFind(flatpak_id); it != command_by_id.cend())
+            by_command[*it].emplace_back(::move(app), PackageSource::Flatpak);
+
+    for (auto &[command, group] : by_command)
+    {
+        if (group.size() < 2)
+            continue;
+
+        ranges::sort(group, {}, [&](const auto &p){ return rank(p.second); });
+        if (ranges::adjacent_find(group, {}, [](const auto &p){ return p.second; }) != group.end())
+            continue;  // Several applications of one source
+
+        const auto &canonical = group.front().first->id();
+        for (auto it = next(group.begin()); it != group.end(); ++it)
+        {
+            DEBG << u"'%1' shadows '%2'."_s.arg(canonical, it->first->id());
+            shadowed_.insert(it->first->id());
+            alternatives_[canonical].emplace_back(it->first);
+        }
+    }
+}
+
+bool Installations::isShadowed(const QString &id) const { return shadowed_.contains(id); }
+
+vector<shared_ptr<Application>> Installations::alternatives(const QString &id) const
+{ return alternatives_.value(id); }
+
+uint Installations::shadowedCount() const { return shadowed_.size(); }
+
+QString Installations::name(PackageSource source)
+{
+    switch (source) {
+    case PackageSource::Native: return u"native"_s;
+    case PackageSource::Flatpak: return u"flatpak"_s;
+    case PackageSource::Snap: return u"snap"_s;
+    case PackageSource::AppImage: return u"appimage"_s;
+    }
+    return {};
+}
+
+optional<PackageSource> Installations::fromName(const QString &name)
+{
+    for (const auto source : sources)
+        if (Installations::name(source) == name)
+            return source;
+    return {};
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <optional>
+#include <vector>
+namespace applications { class Application; }
+class Application;
+
+/// The packaging of an installed application.
+enum class PackageSource { Native, Flatpak, Snap, AppImage };
+
+///
+/// The command wrapped by an Exec command line.
+///
+/// Unwraps `env` invocations, `sh -c` scripts, `flatpak run`, `/snap/bin/` and AppImage
+/// launchers, such that the same application installed from different package sources
+/// yields the same command.
+///
+struct WrappedCommand
+{
+    explicit WrappedCommand(const QStringList &exec);
+
+    QString command;  ///< File name of the command, empty if unknown
+    QString program;  ///< The unwrapped program as given, e.g. 'flatpak' for Flatpak apps
+    QString flatpak_id;  ///< The app id of Flatpak apps
+    bool guessed = false;  ///< The command is the last component of _flatpak_id_
+    PackageSource source = PackageSource::Native;
+};
+
+///
+/// Groups of the same application installed from different package sources.
+///
+/// Applications are grouped by their wrapped command. Since applications of one source
+/// sharing a command are distinct applications, e.g. scripts of an interpreter, such
+/// commands are not grouped at all. Flatpak apps whose command is guessed from their app id
+/// join the group of the application having the app id as desktop id only. Within a group
+/// the installation whose source comes first in the preference is canonical, the others are
+/// shadowed.
+///
+class Installations
+{
+public:
+
+    Installations() = default;
+
+    /// Groups _applications_ preferring the source _preferred_.
+    Installations(const std::vector<std::shared_ptr<applications::Application>> &applications,
+                  PackageSource preferred);
+
+    /// Returns true if the application with id _id_ is shadowed by another installation.
+    bool isShadowed(const QString &id) const;
+
+    /// Returns the shadowed installations of the canonical application with id _id_.
+    std::vector<std::shared_ptr<Application>> alternatives(const QString &id) const;
+
+    /// The number of shadowed applications.
+    uint shadowedCount() const;
+
+    /// Returns the settings name of _source_.
+    static QString name(PackageSource source);
+
+    /// Returns the source with settings name _name_.
+    static std::optional<PackageSource> fromName(const QString &name);
+
+    static constexpr PackageSource sources[] = {
+        PackageSource::Native, PackageSource::Flatpak, PackageSource::Snap, PackageSource::AppImage
+    };
+
+private:
+
+    QSet<QString> shadowed_;
+    QHash<QString, std::vector<std::shared_ptr<Application>>> alternatives_;
+
+};
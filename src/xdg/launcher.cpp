@@ -0,0 +1,134 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "launcher.h"
+#include "launchprofile.h"
+#include <QDir>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <albert/logging.h>
+#include <algorithm>
+using namespace Qt::StringLiterals;
+using namespace std;
+
+Launcher::Launcher(uint capacity):
+    capacity_(capacity),
+    thread_(&Launcher::run, this)
+{}
+
+Launcher::~Launcher()
+{
+    {
+        lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_one();
+    thread_.join();
+}
+
+bool Launcher::submit(Launch launch)
+{
+    {
+        lock_guard lock(mutex_);
+        if (queue_.size() >= capacity_)
+            return false;
+
+        if (!launch.activated.isValid())
+            launch.activated.start();
+        queue_.emplace_back(::move(launch));
+    }
+    condition_.notify_one();
+    return true;
+}
+
+void Launcher::run()
+{
+    for (;;)
+    {
+        unique_lock lock(mutex_);
+        condition_.wait(lock, [this]{ return stop_ || !queue_.empty(); });
+        if (queue_.empty())  // stop_
+            return;
+
+        auto launch = ::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+
+        const auto spawn_ns = launch.activated.nsecsElapsed();
+
+        if (launch.commandline.isEmpty())
+        {
+            emit failed(launch.id, QStringLiteral("Empty command line."));
+            continue;
+        }
+
+        QProcess process;
+        process.setProgram(launch.commandline.first());
+        process.setArguments(launch.commandline.mid(1));
+        process.setWorkingDirectory(launch.working_dir.isEmpty() ? QDir::homePath()
+                                                                 : launch.working_dir);
+        process.setStandardOutputFile(QProcess::nullDevice());
+        process.setStandardErrorFile(QProcess::nullDevice());
+
+        if (!launch.environment.isEmpty())
+        {
+            auto env = QProcessEnvironment::systemEnvironment();
+            for (const auto &var : as_const(launch.environment))
+                env.insert(var.section(u'=', 0, 0), var.section(u'=', 1));
+            process.setProcessEnvironment(env);
+        }
+
+        if (launch.profile)
+        {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+            DEBG << u"Applying launch profile '%1' to '%2'."_s.arg(launch.profile->name(), launch.id);
+            process.setChildProcessModifier([profile = launch.profile]{ profile->apply(); });
+#else
+            // Detached processes run the child process modifier since Qt 6.6 only
+            WARN << u"Launch profiles require Qt 6.6. Ignoring launch profile '%1' of '%2'."_s
+                        .arg(launch.profile->name(), launch.id);
+#endif
+        }
+
+        if (qint64 pid = 0; process.startDetached(&pid))
+        {
+            DEBG << "Spawned" << launch.commandline << "PID:" << pid
+                 << "Startup id:" << launch.startup_id;
+            emit spawned(launch.id, pid, spawn_ns, launch.activated.nsecsElapsed());
+        }
+        else
+        {
+            WARN << "Failed to spawn" << launch.commandline << process.errorString();
+            emit failed(launch.id, process.errorString());
+        }
+    }
+}
+
+size_t LatencyHistogram::bucket(qint64 nsecs)
+{
+    return ranges::lower_bound(bounds_ms, nsecs, {}, [](qint64 ms){ return ms * 1'000'000; })
+           - bounds_ms.begin();
+}
+
+void LatencyHistogram::add(qint64 nsecs)
+{
+    if (samples_.size() == window_)
+        samples_.pop_front();
+    samples_.push_back(nsecs);
+    ++totals_[bucket(nsecs)];
+    sum_ += nsecs;
+}
+
+array<uint, LatencyHistogram::bounds_ms.size() + 1> LatencyHistogram::buckets() const
+{
+    array<uint, bounds_ms.size() + 1> buckets{};
+    for (const auto nsecs : samples_)
+        ++buckets[bucket(nsecs)];
+    return buckets;
+}
+
+uint LatencyHistogram::count() const { return samples_.size(); }
+
+const array<quint64, LatencyHistogram::bounds_ms.size() + 1> &LatencyHistogram::totals() const
+{ return totals_; }
+
+qint64 LatencyHistogram::sum() const { return sum_; }
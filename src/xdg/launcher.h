@@ -0,0 +1,109 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QElapsedTimer>
+#include <QObject>
+#include <QStringList>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+class LaunchProfile;
+
+///
+/// Spawns detached processes on a dedicated thread.
+///
+/// Spawning may block for a long time, e.g. on a loaded machine or on network file systems.
+/// Results are reported asynchronously using the signals, which are emitted from the spawner
+/// thread.
+///
+class Launcher : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    struct Launch
+    {
+        QString id;  ///< The id of the launched application
+        QStringList commandline;
+        QString working_dir;
+        QStringList environment;  ///< Additional KEY=VALUE pairs
+        QString startup_id;  ///< Of the activation, also passed to D-Bus activations
+        QElapsedTimer activated;  ///< Started on user activation, if invalid on submission
+        std::shared_ptr<const LaunchProfile> profile;  ///< Applied in the child, if set
+    };
+
+    /// Starts the spawner thread. At most _capacity_ launches are queued.
+    explicit Launcher(uint capacity = 16);
+
+    /// Spawns the queued launches and stops the spawner thread.
+    ~Launcher();
+
+    /// Queues _launch_. Returns false if the queue is full.
+    bool submit(Launch launch);
+
+signals:
+
+    /// Emitted when the process of the application with id _id_ has been spawned.
+    /// _spawn_ns_ and _exec_ns_ are the times from activation to the start of the spawn and
+    /// to the successful exec respectively.
+    void spawned(const QString &id, qint64 pid, qint64 spawn_ns, qint64 exec_ns);
+
+    /// Emitted when spawning the process of the application with id _id_ failed.
+    void failed(const QString &id, const QString &error);
+
+private:
+
+    void run();
+
+    const uint capacity_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<Launch> queue_;
+    bool stop_ = false;
+    std::thread thread_;
+
+};
+
+
+///
+/// Rolling histogram of the most recent latencies.
+///
+/// Additionally accumulates the bucket counts and the sum of all latencies ever added.
+///
+class LatencyHistogram
+{
+public:
+
+    /// The upper bucket bounds in milliseconds. The last bucket is unbounded.
+    static constexpr std::array<qint64, 12> bounds_ms{1, 2, 5, 10, 20, 50, 100, 200, 500,
+                                                      1000, 2000, 5000};
+
+    /// Adds _nsecs_, dropping the oldest sample if the window is full.
+    void add(qint64 nsecs);
+
+    /// Returns the sample counts per bucket, the last element counts samples exceeding all bounds.
+    std::array<uint, bounds_ms.size() + 1> buckets() const;
+
+    /// Returns the number of samples in the window.
+    uint count() const;
+
+    /// Returns the sample counts per bucket of all samples added, not cumulative over buckets.
+    const std::array<quint64, bounds_ms.size() + 1> &totals() const;
+
+    /// Returns the sum of all samples added in nanoseconds.
+    qint64 sum() const;
+
+private:
+
+    static size_t bucket(qint64 nsecs);
+
+    static constexpr size_t window_ = 64;
+    std::deque<qint64> samples_;
+    std::array<quint64, bounds_ms.size() + 1> totals_{};
+    qint64 sum_ = 0;
+
+};
@@ -0,0 +1,192 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "launchprofile.h"
+#include <QDir>
+#include <QFile>
+#include <QSettings>
+#include <albert/logging.h>
+#include <fcntl.h>
+#include <map>
+#include <sys/resource.h>
+#include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+using namespace Qt::StringLiterals;
+using namespace std;
+
+static const auto sk_launch_profiles = "launch_profiles";
+
+// linux/ioprio.h is not available on all distributions
+static constexpr int ioprio_who_process = 1;
+static constexpr int ioprio_class_shift = 13;
+
+static optional<int> parseIoPriority(const QString &s)
+{
+    static const map<QString, int> classes{
+        {u"realtime"_s, 1}, {u"best-effort"_s, 2}, {u"idle"_s, 3}
+    };
+
+    const auto cls = s.section(u':', 0, 0).trimmed();
+    const auto it = classes.find(cls);
+    if (it == classes.end())
+        return {};
+
+    int level = 4;
+    if (s.contains(u':'))
+    {
+        bool ok;
+        level = s.section(u':', 1).toInt(&ok);
+        if (!ok || level < 0 || level > 7)
+            return {};
+    }
+
+    return it->second << ioprio_class_shift | (it->second == 3 ? 0 : level);
+}
+
+static optional<vector<int>> parseCpuList(const QString &s)
+{
+    vector<int> cpus;
+    for (const auto &range : s.split(u',', Qt::SkipEmptyParts))
+    {
+        bool ok_first, ok_last = true;
+        const int first = range.section(u'-', 0, 0).trimmed().toInt(&ok_first);
+        const int last = range.contains(u'-') ? range.section(u'-', 1).trimmed().toInt(&ok_last)
+                                              : first;
+        if (!ok_first || !ok_last || first < 0 || last < first)
+            return {};
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+vector<shared_ptr<const LaunchProfile>> LaunchProfile::load(QSettings &s)
+{
+    vector<shared_ptr<const LaunchProfile>> profiles;
+
+    s.beginGroup(sk_launch_profiles);
+    for (const auto &name : s.childGroups())
+    {
+        s.beginGroup(name);
+        auto p = make_shared<LaunchProfile>();
+        p->name_ = name;
+
+        for (const auto &m : s.value("match").toStringList())
+            if (m.startsWith(u"category:"_s))
+                p->categories_ << m.mid(9).trimmed();  // size of 'category:'
+            else
+                p->ids_ << m.trimmed();
+
+        bool ok;
+        if (s.contains("nice"))
+        {
+            if (const auto v = s.value("nice").toInt(&ok); ok && v >= -20 && v <= 19)
+                p->nice_ = v;
+            else
+                WARN << u"Launch profile '%1': Invalid nice level."_s.arg(name);
+        }
+
+        if (s.contains("ioprio"))
+        {
+            if (auto v = parseIoPriority(s.value("ioprio").toString()))
+                p->ioprio_ = v;
+            else
+                WARN << u"Launch profile '%1': Invalid I/O priority."_s.arg(name);
+        }
+
+        if (s.contains("cpus"))
+        {
+            if (auto v = parseCpuList(s.value("cpus").toStringList().join(u',')))
+                p->cpus_ = ::move(*v);
+            else
+                WARN << u"Launch profile '%1': Invalid CPU list."_s.arg(name);
+        }
+
+        if (s.contains("oom_score_adj"))
+        {
+            if (const auto v = s.value("oom_score_adj").toInt(&ok); ok && v >= -1000 && v <= 1000)
+                p->oom_score_adj_ = QByteArray::number(v);
+            else
+                WARN << u"Launch profile '%1': Invalid OOM score adjustment."_s.arg(name);
+        }
+
+        if (s.contains("cgroup"))
+        {
+            const auto dir = QDir(u"/sys/fs/cgroup"_s).filePath(s.value("cgroup").toString());
+            if (QFile::exists(dir + u"/cgroup.procs"_s))
+                p->cgroup_procs_ = QFile::encodeName(dir + u"/cgroup.procs"_s);
+            else
+                WARN << u"Launch profile '%1': cgroup '%2' does not exist."_s.arg(name, dir);
+        }
+
+        if (p->ids_.isEmpty() && p->categories_.isEmpty())
+            WARN << u"Launch profile '%1' matches nothing."_s.arg(name);
+        else
+        {
+            DEBG << u"Loaded launch profile '%1'."_s.arg(name);
+            profiles.emplace_back(::move(p));
+        }
+
+        s.endGroup();
+    }
+    s.endGroup();
+
+    return profiles;
+}
+
+shared_ptr<const LaunchProfile>
+LaunchProfile::match(const vector<shared_ptr<const LaunchProfile>> &profiles,
+                     const QString &id, const QStringList &categories)
+{
+    for (const auto &p : profiles)
+        if (p->ids_.contains(id))
+            return p;
+
+    for (const auto &p : profiles)
+        for (const auto &category : categories)
+            if (p->categories_.contains(category))
+                return p;
+
+    return {};
+}
+
+void LaunchProfile::apply() const noexcept
+{
+    if (nice_)
+        setpriority(PRIO_PROCESS, 0, *nice_);
+
+#if defined(Q_OS_LINUX)
+    if (ioprio_)
+        syscall(SYS_ioprio_set, ioprio_who_process, 0, *ioprio_);
+
+    if (!cpus_.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const auto cpu : cpus_)
+            if (cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+
+    if (!oom_score_adj_.isEmpty())
+        if (int fd = ::open("/proc/self/oom_score_adj", O_WRONLY | O_CLOEXEC); fd >= 0)
+        {
+            [[maybe_unused]] auto n = ::write(fd, oom_score_adj_.constData(),
+                                              oom_score_adj_.size());
+            ::close(fd);
+        }
+#endif
+
+    // Writing 0 moves the writing process
+    if (!cgroup_procs_.isEmpty())
+        if (int fd = ::open(cgroup_procs_.constData(), O_WRONLY | O_CLOEXEC); fd >= 0)
+        {
+            [[maybe_unused]] auto n = ::write(fd, "0", 1);
+            ::close(fd);
+        }
+}
+
+const QString &LaunchProfile::name() const { return name_; }
@@ -0,0 +1,59 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <optional>
+#include <vector>
+class QSettings;
+
+///
+/// Scheduling and resource attributes applied to spawned applications.
+///
+/// Configured in the settings group `launch_profiles/<name>` using the keys:
+///
+/// - `match`: Desktop ids and `category:<Category>` entries.
+/// - `nice`: Nice level, -20 to 19. Lower values require privileges.
+/// - `ioprio`: I/O class `idle`, `best-effort[:<0-7>]` or `realtime[:<0-7>]`.
+/// - `cpus`: CPU affinity list, e.g. `0-3,6`.
+/// - `oom_score_adj`: OOM score adjustment, -1000 to 1000. Lower values require privileges.
+/// - `cgroup`: cgroup v2 directory to move the process into. Relative paths are relative
+///   to `/sys/fs/cgroup`. The directory has to be delegated to the user.
+///
+/// The attributes are applied in the child process before exec on a best effort basis.
+/// Launcher applies them with Qt 6.6 or later, which runs the child process modifier of
+/// detached processes.
+///
+class LaunchProfile
+{
+public:
+
+    /// Loads the launch profiles from _settings_.
+    static std::vector<std::shared_ptr<const LaunchProfile>> load(QSettings &settings);
+
+    /// Returns the profile matching the desktop id _id_, else the first one matching one of
+    /// _categories_, else nullptr.
+    static std::shared_ptr<const LaunchProfile>
+    match(const std::vector<std::shared_ptr<const LaunchProfile>> &profiles,
+          const QString &id, const QStringList &categories);
+
+    /// Applies the attributes to the calling process.
+    /// Async-signal-safe, i.e. suitable to be called between fork and exec.
+    void apply() const noexcept;
+
+    const QString &name() const;
+
+private:
+
+    QString name_;
+    QStringList ids_;
+    QStringList categories_;
+    std::optional<int> nice_;
+    std::optional<int> ioprio_;  // Encoded class and data
+    std::vector<int> cpus_;
+    QByteArray oom_score_adj_;  // Preformatted, the child must not allocate
+    QByteArray cgroup_procs_;  // Path of cgroup.procs
+
+};
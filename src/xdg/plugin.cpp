@@ -1,14 +1,30 @@
 // Copyright (c) 2022-2026 Manuel Schneider
 
 #include "application.h"
+#include "dbusactivation.h"
+#include "desktopactionitem.h"
+#include "desktopentryindexer.h"
+#include "directorywalk.h"
+#include "executableindex.h"
+#include "indexscheduler.h"
+#include "installations.h"
+#include "launchprofile.h"
 #include "plugin.h"
+#include "prometheustext.h"
+#include "prebuiltindex.h"
 #include "terminal.h"
 #include "ui_configwidget.h"
+#include <QCheckBox>
 #include <QComboBox>
-#include <QDirIterator>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 #include <QFileInfo>
+#include <QGuiApplication>
+#include <QJsonArray>
 #include <QLabel>
-#include <QRegularExpression>
+#include <QSaveFile>
 #include <QSettings>
 #include <QSignalBlocker>
 #include <QStandardPaths>
@@ -16,17 +32,36 @@
 #include <QWidget>
 #include <albert/logging.h>
 #include <albert/icon.h>
+#include <albert/indexitem.h>
 #include <albert/messagebox.h>
 #include <albert/widgetsutil.h>
+#include <numeric>
 using namespace Qt::StringLiterals;
 using namespace albert;
 using namespace std;
 
 static const auto ck_terminal = "terminal";
+static const auto ck_hide_missing_executables = "hide_missing_executables";
 static const auto ck_ignore_show_in_keys = "ignore_show_in_keys";
 static const auto ck_use_exec            = "use_exec";
 static const auto ck_use_generic_name    = "use_generic_name";
 static const auto ck_use_keywords        = "use_keywords";
+static const auto ck_prefetch            = "prefetch";
+static const auto ck_preferred_source    = "preferred_source";
+static const auto ck_index_desktop_actions = "index_desktop_actions";
+static const auto ck_max_desktop_file_size = "max_desktop_file_size";
+static const auto ck_desktop_file_budget_ms = "desktop_file_budget_ms";
+static const auto ck_index_budget_ms     = "index_budget_ms";
+static const auto ck_metrics_path        = "metrics_path";
+static const auto ck_metrics_interval_s  = "metrics_interval_s";
+
+static const uint prefetch_app_count = 8;
+static const quint64 prefetch_byte_budget = 256 << 20;
+static const qint64 prefetch_interval_ms = 60'000;
+static const int dbus_activation_timeout_ms = 10'000;  // Includes service startup
+static const int dbus_running_activation_timeout_ms = 3'000;  // Owner known to be running
+static const int prewarm_debounce_ms = 150;
+static const qint64 prewarm_interval_ms = 30'000;  // Per application
 
 const map<QString, QStringList> Plugin::exec_args  // command > ExecArg
 {
@@ -91,40 +126,6 @@ const map<QString, QStringList> Plugin::exec_args  // command > ExecArg
     // {"zutty", {}},
 };
 
-static QString normalizedContainerCommand(const QStringList &Exec)
-{
-    QString command;
-
-    // Todo de-env
-    // e.g. env TERM=xterm-256color byobu
-
-    // Flatpak
-    if (QFileInfo(Exec.at(0)).fileName() == u"flatpak"_s)
-    {
-        for (const auto &arg : Exec)
-            if (arg.startsWith(u"--command="_s))
-                command = arg.mid(10);  // size of '--command='
-
-        if (command.isEmpty())
-            WARN << "Flatpak exec commandline w/o '--command':" << Exec.join(QChar::Space);
-    }
-
-    // Snapcraft
-    else if (auto it = find_if(Exec.begin(), Exec.end(),
-                               [](const auto &arg){ return arg.startsWith(u"/snap/bin/"_s); });
-             it != Exec.end())
-    {
-        if (command = it->mid(10); command.isEmpty())  // size of '/snap/bin/'
-            WARN << "Failed getting snap command: Exec:" << Exec.join(QChar::Space);
-    }
-
-    // Native command
-    else
-        command = QFileInfo(Exec.at(0)).fileName();
-
-    return command;
-}
-
 static QStringList appDirectories()
 { return QStandardPaths::standardLocations(QStandardPaths::ApplicationsLocation); }
 
@@ -136,109 +137,156 @@ Plugin::Plugin()
     plugin = this;
 
     fs_watcher.addPaths(appDirectories());
-    connect(&fs_watcher, &QFileSystemWatcher::directoryChanged, this, &Plugin::updateIndexItems);
 
     // Load settings
 
     const auto s = settings();
     commonInitialize(*s);
+    hide_missing_executables_ = s->value(ck_hide_missing_executables, false).value<bool>();
     ignore_show_in_keys_ = s->value(ck_ignore_show_in_keys, true).value<bool>();
     use_exec_            = s->value(ck_use_exec, false).value<bool>();
     use_generic_name_    = s->value(ck_use_generic_name, false).value<bool>();
     use_keywords_        = s->value(ck_use_keywords, false).value<bool>();
+    prefetch_            = s->value(ck_prefetch, false).value<bool>();
+    index_desktop_actions_ = s->value(ck_index_desktop_actions, false).value<bool>();
+    preferred_source_    = Installations::fromName(s->value(ck_preferred_source).toString())
+                               .value_or(PackageSource::Native);
+    installations        = make_shared<const Installations>();
+    launch_profiles      = LaunchProfile::load(*s);
+
+    // Not exposed in the UI, safety nets for pathological setups
+    index_limits.max_file_size = s->value(ck_max_desktop_file_size,
+                                          index_limits.max_file_size).toLongLong();
+    index_limits.file_budget_ms = s->value(ck_desktop_file_budget_ms,
+                                           index_limits.file_budget_ms).toLongLong();
+    index_limits.run_budget_ms = s->value(ck_index_budget_ms,
+                                          index_limits.run_budget_ms).toLongLong();
+    metrics_path = s->value(ck_metrics_path).toString();
 
     // File watches
 
+    DirectoryWalk walk;
     for (const auto &path : QStandardPaths::standardLocations(QStandardPaths::ApplicationsLocation))
-        for (auto dit = QDirIterator(path, QDir::Dirs|QDir::NoDotDot, QDirIterator::Subdirectories); dit.hasNext();)
-            fs_watcher.addPath(QFileInfo(dit.next()).canonicalFilePath());
-
+        walk.walk(path, u".desktop"_s,
+                  [this](const QString &dir){ fs_watcher.addPath(QFileInfo(dir).canonicalFilePath()); },
+                  [](const QString &){});
+
+    // PATH directories, to keep TryExec and Exec checks up to date
+    for (const auto &path : ExecutableIndex::pathDirectories())
+        if (QFileInfo(path).isDir())
+            fs_watcher.addPath(path);
+
+    // Changes of the applications of the user are indexed immediately. Others, e.g. by
+    // package upgrades, are debounced and deferred while the system is under pressure.
+    const auto user_dir = QFileInfo(QStandardPaths::writableLocation(
+                                        QStandardPaths::ApplicationsLocation)).canonicalFilePath();
     connect(&fs_watcher, &QFileSystemWatcher::directoryChanged,
-            this, [this](){ indexer.run(); });
+            this, [this, user_dir](const QString &path){
+                ++watcher_events;
+                index_scheduler.request(!user_dir.isEmpty()
+                                        && (path == user_dir || path.startsWith(user_dir + u'/')));
+            });
 
+    // Launches are spawned asynchronously, report the results
 
-    // Indexer
+    connect(&launcher, &Launcher::spawned, this,
+            [this](const QString &id, qint64, qint64 spawn_ns, qint64 exec_ns)
+            { recordSpawn(id, spawn_ns, exec_ns); });
 
-    indexer.parallel = [this](const bool &abort) -> vector<shared_ptr<applications::Application>>
+    connect(&launcher, &Launcher::failed, this, [this](const QString &id, const QString &error)
     {
-        // Get a map of unique desktop entries according to the spec
+        ++spawn_failures;
+        auto it = ranges::find_if(applications, [&](const auto &a){ return a->id() == id; });
+        warning(tr("Failed to launch '%1': %2")
+                    .arg(it == applications.end() ? id : (*it)->name(), error));
+    });
 
-        map<QString, QString> desktop_files;  // Desktop id > path
-        for (const QString &dir : appDirectories())
-        {
-            DEBG << "Scanning desktop entries in:" << dir;
+    // Warm the page cache for the most launched apps whenever albert becomes active
 
-            QDirIterator it(dir, {u"*.desktop"_s}, QDir::Files,
-                            QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
+    connect(qGuiApp, &QGuiApplication::applicationStateChanged,
+            this, [this](Qt::ApplicationState state){
+                if (state == Qt::ApplicationActive)
+                    prefetchMostLaunched();
+            });
 
-            while (it.hasNext())
-            {
-                auto path = it.next();
+    // Prepare the launch of the top ranked item once typing pauses
 
-                // To determine the ID of a desktop file, make its full path relative to
-                // the $XDG_DATA_DIRS component in which the desktop file is installed,
-                // remove the "applications/" prefix, and turn '/' into '-'. Chop off '.desktop'.
-                static QRegularExpression re(u"^.*applications/"_s);
-                QString id = QString(path).remove(re).replace(u'/', u'-').chopped(8);
+    prewarm_timer.setSingleShot(true);
+    prewarm_timer.setInterval(prewarm_debounce_ms);
+    connect(&prewarm_timer, &QTimer::timeout, this, [this]{ prewarm(prewarm_candidate); });
 
-                if (const auto &[dit, success] = desktop_files.emplace(id, path); !success)
-                    DEBG << u"Desktop file '%1' at '%2' will be skipped: Shadowed by '%3'"_s
-                                .arg(id, path, desktop_files[id]);
-            }
-        }
+    // Export metrics for the node_exporter textfile collector
+
+    if (!metrics_path.isEmpty())
+    {
+        connect(&metrics_timer, &QTimer::timeout, this, &Plugin::writeMetrics);
+        metrics_timer.start(max(1, s->value(ck_metrics_interval_s, 60).toInt()) * 1000);
+    }
+
+    // Indexer
 
-        Application::ParseOptions po{
+    const auto index = [this](const bool &abort) -> vector<shared_ptr<applications::Application>>
+    {
+        indexRunStarted();
+
+        const ::Application::ParseOptions po{
+            .hide_missing_executables = hideMissingExecutables(),
             .ignore_show_in_keys = ignoreShowInKeys(),
             .use_exec = useExec(),
             .use_generic_name = useGenericName(),
             .use_keywords = useKeywords(),
-            .use_non_localized_name = useNonLocalizedName()
+            .use_non_localized_name = useNonLocalizedName(),
+            .executables = nullptr
         };
 
-        // Index the unique desktop files
-        vector<shared_ptr<applications::Application>> apps;
-        for (const auto &[id, path] : desktop_files)
-        {
-            if (abort)
-                return apps;
+        // Layers the desktop files of the user and modified ones over the prebuilt index
+        const PrebuiltIndex prebuilt(PrebuiltIndex::defaultPath(), po);
 
-            try
-            {
-                apps.emplace_back(make_shared<Application>(id, path, po));
-                DEBG << u"Valid desktop file '%1': '%2'"_s.arg(id, path);
-            }
-            catch (const exception &e)
-            {
-                DEBG << u"Skipped desktop entry '%1':"_s.arg(path) << e.what();
-            }
-        }
+        auto r = DesktopEntryIndexer::run(appDirectories(), po, abort,
+                                          prebuilt.isValid() ? &prebuilt : nullptr,
+                                          &parse_cache, index_limits);
 
-        return apps;
-    };
+        DEBG << u"Scanned %1 desktop files in %2 ms, parsed in %3 ms, %4 prebuilt, %5 cached."_s
+                    .arg(r.statistics.desktop_files)
+                    .arg(r.statistics.scan_ns / 1'000'000)
+                    .arg(r.statistics.parse_ns / 1'000'000)
+                    .arg(r.statistics.prebuilt)
+                    .arg(r.statistics.cached);
 
-    indexer.finish = [this]
-    {
-        applications = indexer.takeResult();
+        ++index_runs;
+        if (r.statistics.over_budget)
+            ++index_runs_over_budget;
+        if (!abort)
+        {
+            lock_guard lock(index_statistics_mutex);
+            index_statistics = r.statistics;
+        }
 
-        INFO << u"Indexed %1 applications."_s.arg(applications.size());
+        // Nothing to publish, skip classifying and diffing too
+        result_fingerprint = r.fingerprint;
+        index_run_unchanged = r.fingerprint && r.fingerprint == indexed_fingerprint;
+        if (index_run_unchanged)
+        {
+            ++index_runs_unchanged;
+            indexRunFinished(abort);
+            return {};
+        }
 
-        // Replace terminal apps with terminals and populate terminals
-        // Filter supported terms by availability using destkop id
+        vector<shared_ptr<applications::Application>> apps{r.applications.begin(),
+                                                           r.applications.end()};
 
-        terminals.clear();
+        // Replace terminal apps with terminals
+        // Filter supported terms by availability using destkop id
 
-        for (auto &base : applications)
-            if (auto app = static_pointer_cast<::Application>(base);
-                app->isTerminal())
+        for (auto &base : apps)
+            if (abort)
+                break;
+            else if (auto app = static_pointer_cast<::Application>(base); app->isTerminal())
             {
-                if (auto command = normalizedContainerCommand(app->exec());
-                    !command.isEmpty())
-                    if (auto it = exec_args.find(command); it != exec_args.end())
-                    {
-                        auto term = make_shared<Terminal>(*app, it->second);
-                        base = static_pointer_cast<::Application>(term);
-                        terminals.emplace_back(term.get());
-                    }
+                // A command guessed from a Flatpak id may be the one of another terminal
+                if (const WrappedCommand w(app->exec()); !w.command.isEmpty() && !w.guessed)
+                    if (auto it = exec_args.find(w.command); it != exec_args.end())
+                        base = make_shared<Terminal>(*app, it->second);
                     else
                         WARN << u"Terminal '%1' not supported. Please post an issue. Exec: %2"_s
                                     .arg(app->id(), app->exec().join(QChar::Space));
@@ -247,6 +295,52 @@ Plugin::Plugin()
                                 .arg(app->id(), app->exec().join(QChar::Space));
             }
 
+        indexRunFinished(abort);
+        return apps;
+    };
+
+    indexer.parallel = [index, run_idle = index_scheduler.idleRunner()](const bool &abort)
+    {
+        vector<shared_ptr<applications::Application>> apps;
+        run_idle([&]{ apps = index(abort); });
+        return apps;
+    };
+
+    indexer.finish = [this]
+    {
+        auto apps = indexer.takeResult();
+        if (index_run_aborted)
+        {
+            DEBG << "Discarding the result of an aborted index run.";
+            return;
+        }
+        else if (index_run_unchanged)
+        {
+            DEBG << u"Indexed %1 applications. Fingerprint unchanged."_s.arg(applications.size());
+            return;
+        }
+
+        const auto delta = replaceApplications(::move(apps));
+        indexed_fingerprint = result_fingerprint.load();
+        if (delta.empty())
+        {
+            DEBG << u"Indexed %1 applications. No changes."_s.arg(applications.size());
+            return;
+        }
+
+        INFO << u"Indexed %1 applications. Added %2, removed %3, modified %4."_s
+                    .arg(applications.size())
+                    .arg(delta.added.size())
+                    .arg(delta.removed.size())
+                    .arg(delta.modified.size());
+
+        // Populate terminals, unchanged terminals are kept by replaceApplications
+
+        terminals.clear();
+        for (const auto &app : applications)
+            if (auto *term = dynamic_cast<Terminal*>(app.get()))
+                terminals.emplace_back(term);
+
         if (terminals.empty())
         {
             WARN << "No terminals available.";
@@ -272,20 +366,97 @@ Plugin::Plugin()
             }
         }
 
-        setIndexItems(buildIndexItems());
+        groupInstallations();
+        publishSnapshot();
+        publishIndexItems();
 
-        emit appsChanged();
+        emit appsChanged(delta);
     };
 }
 
 Plugin::~Plugin() = default;
 
+void Plugin::retranslate()
+{
+    PluginBase::retranslate();
+    ::Application::retranslate();
+}
+
+QString Plugin::executableName(const applications::Application &app) const
+{ return QFileInfo(static_cast<const ::Application &>(app).exec().at(0)).fileName(); }
+
+QStringList Plugin::windowClasses(const applications::Application &iapp) const
+{
+    const auto &app = static_cast<const ::Application &>(iapp);
+
+    // Reverse DNS ids, e.g. X11 windows of org.gnome.Nautilus have the class 'Nautilus'
+    auto id = app.id();
+    const auto last_component = id.contains(u'.') ? id.section(u'.', -1) : QString();
+
+    return {
+        app.startupWMClass(),
+        id,
+        app.flatpakId(),
+        last_component,
+        WrappedCommand(app.exec()).command
+    };
+}
+
+QStringList Plugin::categories(const applications::Application &app) const
+{ return static_cast<const ::Application &>(app).categories(); }
+
+bool Plugin::isIndexed(const applications::Application &app) const
+{ return !installations.load(memory_order_acquire)->isShadowed(app.id()); }
+
+void Plugin::addIndexItems(const shared_ptr<applications::Application> &iapp,
+                           vector<IndexItem> &items) const
+{
+    if (!index_desktop_actions_)
+        return;
+
+    auto app = static_pointer_cast<const ::Application>(iapp);
+    for (const auto &a : app->desktopActions())
+    {
+        auto item = make_shared<DesktopActionItem>(app, a);
+        items.emplace_back(item, a.name_);
+        items.emplace_back(::move(item), app->name() + QChar::Space + a.name_);
+    }
+}
+
+vector<shared_ptr<::Application>> Plugin::alternatives(const QString &id) const
+{ return installations.load(memory_order_acquire)->alternatives(id); }
+
+void Plugin::groupInstallations()
+{
+    auto i = make_shared<const Installations>(applications, preferred_source_);
+    if (i->shadowedCount())
+        INFO << u"%1 applications are shadowed by installations from preferred sources."_s
+                    .arg(i->shadowedCount());
+    installations.store(::move(i), memory_order_release);
+}
+
+QString Plugin::displayName(PackageSource source)
+{
+    switch (source) {
+    case PackageSource::Native: return tr("System package");
+    case PackageSource::Flatpak: return u"Flatpak"_s;
+    case PackageSource::Snap: return u"Snap"_s;
+    case PackageSource::AppImage: return u"AppImage"_s;
+    }
+    return {};
+}
+
 QWidget *Plugin::buildConfigWidget()
 {
     auto widget = new QWidget;
     Ui::ConfigWidget ui;
     ui.setupUi(widget);
 
+    bindWidget(ui.checkBox_hideMissingExecutables,
+               this,
+               &Plugin::hideMissingExecutables,
+               &Plugin::setHideMissingExecutables);
+
     bindWidget(ui.checkBox_ignoreShowInKeys,
                this,
                &Plugin::ignoreShowInKeys,
@@ -308,6 +479,32 @@ QWidget *Plugin::buildConfigWidget()
 
     addBaseConfig(ui.formLayout);
 
+    auto *cb = new QCheckBox;
+    cb->setToolTip(tr("Preload the executables and libraries of the most frequently launched "
+                      "applications into the page cache when the launcher is shown, and of the "
+                      "top result while typing."));
+    ui.formLayout->addRow(tr("Preload frequently launched applications"), cb);
+    bindWidget(cb, this, &Plugin::prefetch, &Plugin::setPrefetch);
+
+    cb = new QCheckBox;
+    cb->setToolTip(tr("Make the desktop actions of applications, e.g. 'New Private Window', "
+                      "searchable items of their own."));
+    ui.formLayout->addRow(tr("Index desktop actions"), cb);
+    bindWidget(cb, this, &Plugin::indexDesktopActions, &Plugin::setIndexDesktopActions);
+
+    auto *sources = new QComboBox;
+    sources->setToolTip(tr("Applications installed from several package sources, e.g. natively "
+                           "and as Flatpak, are listed once. The installations from the other "
+                           "sources are available as actions."));
+    for (const auto source : Installations::sources)
+        sources->addItem(displayName(source), Installations::name(source));
+    sources->setCurrentIndex(sources->findData(Installations::name(preferred_source_)));
+    connect(sources, &QComboBox::currentIndexChanged, this, [this, sources]{
+        if (auto s = Installations::fromName(sources->currentData().toString()))
+            setPreferredSource(*s);
+    });
+    ui.formLayout->addRow(tr("Preferred package source"), sources);
+
     ui.formLayout->addRow(tr("Terminal"), createTerminalFormWidget());
 
     return widget;
@@ -339,7 +536,20 @@ QWidget *Plugin::createTerminalFormWidget()
         }
     };
 
-    connect(this, &PluginBase::appsChanged, cb, updateTerminalsCheckBox);
+    // Rebuild only if a terminal changed
+    connect(this, &PluginBase::appsChanged, cb, [this, cb, updateTerminalsCheckBox](const Delta &d)
+    {
+        auto isTerminal = [&](const QString &id)
+        {
+            return cb->findData(id) >= 0
+                   || ranges::any_of(terminals, [&](const auto *t){ return t->id() == id; });
+        };
+
+        if (ranges::any_of(d.added, isTerminal)
+            || ranges::any_of(d.removed, isTerminal)
+            || ranges::any_of(d.modified, isTerminal))
+            updateTerminalsCheckBox();
+    });
 
     updateTerminalsCheckBox();
 
@@ -385,6 +595,255 @@ void Plugin::runTerminal(QStringList commandline, const QString working_dir) con
     terminal->launch(commandline, working_dir);
 }
 
+void Plugin::runDetached(Launcher::Launch launch) const
+{
+    const auto id = launch.id;
+    if (!launcher.submit(::move(launch)))
+    {
+        WARN << "Launch queue full. Dropped launch of" << id;
+        warning(tr("Too many pending launches."));
+    }
+}
+
+shared_ptr<const LaunchProfile> Plugin::launchProfile(const QString &id,
+                                                      const QStringList &categories) const
+{ return LaunchProfile::match(launch_profiles, id, categories); }
+
+void Plugin::activateDBus(const QString &action, Launcher::Launch fallback)
+{
+    auto bus = QDBusConnection::sessionBus();
+    if (!bus.isConnected())
+    {
+        WARN << "No session bus. Launching via Exec:" << fallback.id;
+        runDetached(::move(fallback));
+        return;
+    }
+
+    const auto msg = DBusActivation::message(fallback.id, action, fallback.startup_id);
+
+    // A running instance answers without a service startup, hence fails over to Exec sooner
+    auto timeout = dbus_activation_timeout_ms;
+    if (auto it = prewarmed.find(fallback.id);
+        it != prewarmed.end() && it->second.elapsed.elapsed() < prewarm_interval_ms
+        && it->second.dbus_running.value_or(false))
+        timeout = dbus_running_activation_timeout_ms;
+
+    auto *watcher = new QDBusPendingCallWatcher(bus.asyncCall(msg, timeout), this);
+
+    connect(watcher, &QDBusPendingCallWatcher::finished, this,
+            [this, fallback = ::move(fallback)](QDBusPendingCallWatcher *w) mutable
+    {
+        w->deleteLater();
+        if (QDBusPendingReply<> reply = *w; reply.isError())
+        {
+            ++dbus_failures;
+            WARN << u"D-Bus activation of '%1' failed, launching via Exec: %2"_s
+                        .arg(fallback.id, reply.error().message());
+
+            // The spawn latencies of the fallback exclude the failed activation
+            fallback.activated.start();
+            runDetached(::move(fallback));
+        }
+        else
+        {
+            ++dbus_activations;
+            DEBG << u"Activated '%1' via D-Bus in %2 ms. Startup id: %3"_s
+                        .arg(fallback.id).arg(fallback.activated.elapsed())
+                        .arg(fallback.startup_id);
+        }
+    });
+}
+
+// Returns the path of the binary of _app_. Empty for Flatpak, Snap and AppImage launches,
+// whose program is a launcher or an image instead of the binary of the application.
+static QString prefetchableExecutable(const ::Application &app)
+{
+    if (const WrappedCommand w(app.exec());
+        w.source == PackageSource::Native && !w.program.isEmpty())
+        return QStandardPaths::findExecutable(w.program);
+    return {};
+}
+
+void Plugin::prefetchMostLaunched()
+{
+    if (!prefetch_ || (last_prefetch.isValid() && last_prefetch.elapsed() < prefetch_interval_ms))
+        return;
+
+    last_prefetch.start();
+    prefetched_ids = mostLaunched(prefetch_app_count);
+
+    QStringList executables;
+    for (const auto &id : as_const(prefetched_ids))
+        if (auto it = ranges::find_if(applications, [&](const auto &a){ return a->id() == id; });
+            it != applications.end())
+            if (auto exe = prefetchableExecutable(*static_pointer_cast<::Application>(*it));
+                !exe.isEmpty())
+                executables << exe;
+
+    prefetcher.prefetch(executables, prefetch_byte_budget);
+}
+
+void Plugin::topRankedItem(const Item &item)
+{
+    if (!prefetch_)
+        return;
+
+    // Called in the query thread. Desktop action items have ids '<app id>/<action id>'.
+    QMetaObject::invokeMethod(this, [this, id = item.id().section(u'/', 0, 0)]{
+        prewarm_candidate = id;
+        prewarm_timer.start();
+    }, Qt::QueuedConnection);
+}
+
+void Plugin::prewarm(const QString &id)
+{
+    if (auto it = prewarmed.find(id);
+        it != prewarmed.end() && it->second.elapsed.elapsed() < prewarm_interval_ms)
+        return;
+
+    const auto app = static_pointer_cast<::Application>(snapshot()->byId(id));
+    if (!app)
+        return;
+
+    erase_if(prewarmed, [](const auto &p)
+             { return p.second.elapsed.elapsed() >= prewarm_interval_ms; });
+    auto &p = prewarmed[id] = {};
+    p.elapsed.start();
+    ++prewarms;
+
+    DEBG << "Prewarming" << id;
+
+    if (auto exe = prefetchableExecutable(*app); !exe.isEmpty())
+        prefetcher.prefetch({exe}, prefetch_byte_budget);
+
+    // Connects to the bus ahead of the activation, if not yet connected, and checks whether
+    // the application is running, which determines the activation timeout
+    if (app->isDBusActivatable())
+        if (auto bus = QDBusConnection::sessionBus(); bus.isConnected())
+        {
+            auto msg = QDBusMessage::createMethodCall(u"org.freedesktop.DBus"_s,
+                                                      u"/org/freedesktop/DBus"_s,
+                                                      u"org.freedesktop.DBus"_s,
+                                                      u"NameHasOwner"_s);
+            msg << id;
+            auto *watcher = new QDBusPendingCallWatcher(bus.asyncCall(msg), this);
+            connect(watcher, &QDBusPendingCallWatcher::finished, this,
+                    [this, id](QDBusPendingCallWatcher *w)
+            {
+                w->deleteLater();
+                if (QDBusPendingReply<bool> reply = *w; !reply.isError())
+                {
+                    DEBG << u"'%1' %2"_s.arg(id, reply.value() ? u"is running."_s
+                                                               : u"will be started by the bus."_s);
+                    if (auto it = prewarmed.find(id); it != prewarmed.end())
+                        it->second.dbus_running = reply.value();
+                }
+            });
+        }
+}
+
+void Plugin::recordSpawn(const QString &id, qint64 spawn_ns, qint64 exec_ns)
+{
+    const auto it = prewarmed.find(id);
+    const bool prewarmed_recently = it != prewarmed.end()
+                                    && it->second.elapsed.elapsed() < prewarm_interval_ms;
+    if (prefetched_ids.contains(id) || prewarmed_recently)
+        ++spawns_prefetched;
+
+    // Exec returns before the dynamic loader maps any library, the page cache is not involved
+    ++spawns.count;
+    spawns.nsecs += exec_ns - spawn_ns;
+
+    auto &l = launch_latencies[id];
+    l.spawn.add(spawn_ns);
+    l.exec.add(exec_ns);
+
+    DEBG << u"Launched '%1'. Spawn: %2 ms, exec: %3 ms."_s
+                .arg(id).arg(spawn_ns / 1e6).arg(exec_ns / 1e6);
+}
+
+void Plugin::writeMetrics() const
+{
+    DesktopEntryIndexer::Statistics st;
+    {
+        lock_guard lock(index_statistics_mutex);
+        st = index_statistics;
+    }
+
+    PrometheusText m;
+
+    m.family("albert_applications_index_runs_total", "counter",
+             "Index runs, including aborted ones.");
+    m.sample("", {}, index_runs);
+    m.family("albert_applications_index_runs_aborted_total", "counter", "Aborted index runs.");
+    m.sample("", {}, index_runs_aborted);
+    m.family("albert_applications_index_runs_unchanged_total", "counter",
+             "Index runs without content changes.");
+    m.sample("", {}, index_runs_unchanged);
+    m.family("albert_applications_index_runs_over_budget_total", "counter",
+             "Index runs exceeding their time budget.");
+    m.sample("", {}, index_runs_over_budget);
+    m.family("albert_applications_index_deferrals_total", "counter",
+             "Index runs deferred due to system pressure.");
+    m.sample("", {}, index_scheduler.deferrals());
+    m.family("albert_applications_watcher_events_total", "counter",
+             "File system watcher events.");
+    m.sample("", {}, watcher_events);
+
+    m.family("albert_applications_index_phase_seconds", "gauge",
+             "Phase durations of the last completed index run.");
+    m.sample("", {{"phase", u"scan"_s}}, st.scan_ns / 1e9);
+    m.sample("", {{"phase", u"parse"_s}}, st.parse_ns / 1e9);
+    m.family("albert_applications_index_desktop_files", "gauge",
+             "Unique desktop files found by the last completed index run.");
+    m.sample("", {}, st.desktop_files);
+    m.family("albert_applications_index_skipped", "gauge",
+             "Desktop files skipped by the last completed index run.");
+    for (const auto &[reason, count] : st.skip_reasons)
+        m.sample("", {{"reason", reason}}, count);
+    m.family("albert_applications_index_cache_hit_ratio", "gauge",
+             "Share of the desktop files of the last completed index run reused from "
+             "previous runs.");
+    m.sample("", {}, st.desktop_files ? double(st.cached) / st.desktop_files : 0.);
+    m.family("albert_applications_applications", "gauge", "Indexed applications.");
+    m.sample("", {}, applications.size());
+
+    m.family("albert_applications_launch_failures_total", "counter", "Failed spawns.");
+    m.sample("", {}, spawn_failures);
+    m.family("albert_applications_dbus_activations_total", "counter",
+             "Activations via org.freedesktop.Application.");
+    m.sample("", {}, dbus_activations);
+
+    vector<double> bounds;
+    for (const auto ms : LatencyHistogram::bounds_ms)
+        bounds.emplace_back(ms / 1e3);
+
+    auto histogram = [&](const QString &id, const LatencyHistogram &h)
+    {
+        const auto &totals = h.totals();
+        m.histogram({{"id", id}}, bounds, {totals.begin(), totals.end()}, h.sum() / 1e9);
+    };
+
+    m.family("albert_applications_launches_total", "counter",
+             "Spawned launches by desktop id.");
+    for (const auto &[id, l] : launch_latencies)
+        m.sample("", {{"id", id}},
+                 accumulate(l.spawn.totals().begin(), l.spawn.totals().end(), 0ull));
+    m.family("albert_applications_launch_spawn_seconds", "histogram",
+             "Latency from activation to spawn by desktop id.");
+    for (const auto &[id, l] : launch_latencies)
+        histogram(id, l.spawn);
+    m.family("albert_applications_launch_exec_seconds", "histogram",
+             "Latency from activation to exec by desktop id.");
+    for (const auto &[id, l] : launch_latencies)
+        histogram(id, l.exec);
+
+    // Atomically replaced by rename, scrapers never see partial files
+    QSaveFile file(metrics_path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(m.text()) < 0 || !file.commit())
+        WARN << u"Failed to write metrics to '%1': %2"_s.arg(metrics_path, file.errorString());
+}
+
 QJsonObject Plugin::telemetryData() const
 {
     QJsonObject t;
@@ -394,10 +853,91 @@ QJsonObject Plugin::telemetryData() const
 
     QJsonObject o;
     o.insert(u"terminals"_s, t);
+
+    if (prefetch_)
+    {
+        const auto stats = prefetcher.statistics();
+
+        QJsonObject p;
+        p.insert(u"runs"_s, int(stats.runs));
+        p.insert(u"files"_s, int(stats.files));
+        p.insert(u"bytes"_s, qint64(stats.bytes));
+        p.insert(u"duration_ms"_s, stats.duration_ms);
+        p.insert(u"prewarms"_s, int(prewarms));
+        p.insert(u"launches_prefetched"_s, int(spawns_prefetched));
+        o.insert(u"prefetch"_s, p);
+    }
+
+    QJsonObject l;
+    l.insert(u"spawned"_s, int(spawns.count));
+    l.insert(u"spawn_to_exec_ms_mean"_s,
+             spawns.count ? double(spawns.nsecs) / spawns.count / 1e6 : 0.);
+    l.insert(u"failed"_s, int(spawn_failures));
+    l.insert(u"dbus_activated"_s, int(dbus_activations));
+    l.insert(u"dbus_failed"_s, int(dbus_failures));
+    o.insert(u"launches"_s, l);
+
+    auto toJson = [](const LatencyHistogram &h)
+    {
+        QJsonArray a;
+        for (const auto count : h.buckets())
+            a.append(int(count));
+        return a;
+    };
+
+    QJsonArray bounds;
+    for (const auto ms : LatencyHistogram::bounds_ms)
+        bounds.append(ms);
+
+    QJsonObject latencies;
+    for (const auto &[id, h] : launch_latencies)
+    {
+        QJsonObject a;
+        a.insert(u"spawn"_s, toJson(h.spawn));
+        a.insert(u"exec"_s, toJson(h.exec));
+        latencies.insert(id, a);
+    }
+
+    QJsonObject ll;
+    ll.insert(u"bounds_ms"_s, bounds);
+    ll.insert(u"apps"_s, latencies);
+    o.insert(u"launch_latency"_s, ll);
+
+    QJsonObject ix;
+    ix.insert(u"runs_aborted"_s, int(index_runs_aborted));
+    ix.insert(u"restarts"_s, int(index_restarts));
+    ix.insert(u"runs_unchanged"_s, int(index_runs_unchanged));
+    ix.insert(u"runs_over_budget"_s, int(index_runs_over_budget));
+    ix.insert(u"deferrals"_s, int(index_scheduler.deferrals()));
+    ix.insert(u"shadowed"_s, int(installations.load()->shadowedCount()));
+    ix.insert(u"restart_ms_mean"_s,
+              index_restarts ? double(restart_ns) / index_restarts / 1e6 : 0.);
+    o.insert(u"indexer"_s, ix);
+
+    if (memory_accounting)
+    {
+        auto m = memory_report.toJson();
+        m.insert(u"applications"_s, int(applications.size()));
+        m.insert(u"peak_overlapping"_s, qint64(memory_peak));
+        o.insert(u"memory"_s, m);
+    }
+
     return o;
 }
 
 
+bool Plugin::hideMissingExecutables() const { return hide_missing_executables_; }
+
+void Plugin::setHideMissingExecutables(bool v)
+{
+    if (hide_missing_executables_ != v)
+    {
+        settings()->setValue(ck_hide_missing_executables, v);
+        hide_missing_executables_ = v;
+        updateIndexItems();
+    }
+}
+
 bool Plugin::ignoreShowInKeys() const { return ignore_show_in_keys_; }
 
 void Plugin::setIgnoreShowInKeys(bool v)
@@ -445,3 +985,40 @@ void Plugin::setUseKeywords(bool v)
         updateIndexItems();
     }
 }
+
+bool Plugin::prefetch() const { return prefetch_; }
+
+void Plugin::setPrefetch(bool v)
+{
+    if (prefetch_ != v)
+    {
+        settings()->setValue(ck_prefetch, v);
+        prefetch_ = v;
+    }
+}
+
+bool Plugin::indexDesktopActions() const { return index_desktop_actions_; }
+
+void Plugin::setIndexDesktopActions(bool v)
+{
+    if (index_desktop_actions_ != v)
+    {
+        settings()->setValue(ck_index_desktop_actions, v);
+        index_desktop_actions_ = v;
+        index_item_cache.clear();
+        publishIndexItems();
+    }
+}
+
+PackageSource Plugin::preferredSource() const { return preferred_source_; }
+
+void Plugin::setPreferredSource(PackageSource v)
+{
+    if (preferred_source_ != v)
+    {
+        settings()->setValue(ck_preferred_source, Installations::name(v));
+        preferred_source_ = v;
+        groupInstallations();
+        publishIndexItems();
+    }
+}
@@ -1,9 +1,19 @@
 // Copyright (c) 2022-2026 Manuel Schneider
 
 #pragma once
+#include "desktopentryindexer.h"
+#include "indexscheduler.h"
+#include "installations.h"
+#include "launcher.h"
 #include "pluginbase.h"
+#include "prefetcher.h"
+#include <QElapsedTimer>
 #include <QStringList>
+#include <QTimer>
 #include <albert/telemetryprovider.h>
+#include <mutex>
+#include <optional>
+class LaunchProfile;
 class Terminal;
 
 class Plugin : public PluginBase,
@@ -25,6 +35,27 @@ public:
     void runTerminal(const QString &script) const override;
     void runTerminal(QStringList commandline, const QString working_dir = {}) const;
 
+    /// Spawns _launch_ asynchronously.
+    void runDetached(Launcher::Launch launch) const;
+
+    /// Returns the launch profile for the application with id _id_ and _categories_.
+    std::shared_ptr<const LaunchProfile> launchProfile(const QString &id,
+                                                       const QStringList &categories) const;
+
+    /// Activates the application of _fallback_ via org.freedesktop.Application, or its
+    /// desktop action _action_ if not empty, passing the startup id of _fallback_.
+    /// Spawns _fallback_ if the activation fails.
+    void activateDBus(const QString &action, Launcher::Launch fallback);
+
+    /// Returns the installations from other package sources of the application with id _id_.
+    std::vector<std::shared_ptr<::Application>> alternatives(const QString &id) const;
+
+    /// Returns the display name of _source_.
+    static QString displayName(PackageSource source);
+
+    bool hideMissingExecutables() const;
+    void setHideMissingExecutables(bool);
+
     bool ignoreShowInKeys() const;
     void setIgnoreShowInKeys(bool);
 
@@ -37,17 +68,97 @@ public:
     bool useKeywords() const;
     void setUseKeywords(bool);
 
+    bool prefetch() const;
+    void setPrefetch(bool);
+
+    bool indexDesktopActions() const;
+    void setIndexDesktopActions(bool);
+
+    PackageSource preferredSource() const;
+    void setPreferredSource(PackageSource);
+
+protected:
+
+    void retranslate() override;
+    QString executableName(const applications::Application &) const override;
+    QStringList windowClasses(const applications::Application &) const override;
+    QStringList categories(const applications::Application &) const override;
+    bool isIndexed(const applications::Application &) const override;
+    void addIndexItems(const std::shared_ptr<applications::Application> &,
+                       std::vector<albert::IndexItem> &) const override;
+    void topRankedItem(const albert::Item &) override;
+
 private:
 
     static const std::map<QString, QStringList> exec_args;
 
     QWidget *createTerminalFormWidget();
+    void prefetchMostLaunched();
+    void prewarm(const QString &id);
+    void groupInstallations();
+    void recordSpawn(const QString &id, qint64 spawn_ns, qint64 exec_ns);
+    void writeMetrics() const;
+
+    struct SpawnStatistics
+    {
+        uint count = 0;
+        qint64 nsecs = 0;  // Start of the spawn to the return of exec
+    };
+
+    struct LaunchLatencies
+    {
+        LatencyHistogram spawn;  // Activation to spawn
+        LatencyHistogram exec;  // Activation to exec
+    };
 
     std::vector<Terminal*> terminals;
     Terminal* terminal = nullptr;
+    mutable Launcher launcher;
+    Prefetcher prefetcher;
+    QElapsedTimer last_prefetch;
+    QStringList prefetched_ids;
+    QTimer prewarm_timer;  // Debounces the top ranked items
+    QString prewarm_candidate;
+    struct Prewarm
+    {
+        QElapsedTimer elapsed;
+        std::optional<bool> dbus_running;  // Whether the bus name had an owner, if checked
+    };
+
+    std::map<QString, Prewarm> prewarmed;  // Id > last prewarm
+    uint prewarms = 0;
+    SpawnStatistics spawns;
+    uint spawns_prefetched = 0;  // Of prefetched or recently prewarmed applications
+    uint spawn_failures = 0;
+    uint dbus_activations = 0;
+    uint dbus_failures = 0;
+    std::map<QString, LaunchLatencies> launch_latencies;
+    std::vector<std::shared_ptr<const LaunchProfile>> launch_profiles;
+    DesktopEntryIndexer::ParseCache parse_cache;  // Used by the indexer thread only
+    DesktopEntryIndexer::Limits index_limits;
+    std::atomic_uint index_runs_over_budget = 0;
+    std::atomic_uint index_runs = 0;
+    mutable std::mutex index_statistics_mutex;
+    DesktopEntryIndexer::Statistics index_statistics;  // Of the last completed run
+    uint watcher_events = 0;
+    QString metrics_path;  // Empty if the export is disabled
+    QTimer metrics_timer;
+    std::atomic<size_t> result_fingerprint = 0;  // Of the last index run
+    std::atomic<size_t> indexed_fingerprint = 0;  // Of the applications
+    std::atomic_bool index_run_unchanged = false;
+    std::atomic_uint index_runs_unchanged = 0;
+    std::atomic<std::shared_ptr<const Installations>> installations;
+    bool hide_missing_executables_;
     bool ignore_show_in_keys_;
     bool use_exec_;
     bool use_generic_name_;
     bool use_keywords_;
+    std::atomic_bool prefetch_;  // Read by the query thread
+    bool index_desktop_actions_;
+    PackageSource preferred_source_;
+
+    // Last, such that it waits for a run in flight before the members it uses are destroyed.
+    // Runs started by the executor, which is destroyed later, return without indexing.
+    IndexScheduler index_scheduler{[this]{ updateIndexItems(); }};
 
 };
@@ -0,0 +1,201 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "desktopentry.h"
+#include "desktopentryindexer.h"
+#include "executableindex.h"
+#include "prebuiltindex.h"
+#include <QBuffer>
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <albert/logging.h>
+using namespace Qt::StringLiterals;
+using namespace std;
+
+static const quint32 magic = 0x414c4249;  // 'ALBI'
+static const quint32 version = 4;
+static const auto stream_version = QDataStream::Qt_6_0;
+
+enum Status : quint8 { Parsed, Skipped };
+
+// OnlyShowIn and NotShowIn are evaluated at write time against the current desktops
+static QString showInDesktops(const Application::ParseOptions &po)
+{ return po.ignore_show_in_keys ? QString() : qEnvironmentVariable("XDG_CURRENT_DESKTOP"); }
+
+QString PrebuiltIndex::defaultPath()
+{
+    if (qEnvironmentVariableIsSet("ALBERT_APPLICATIONS_PREBUILT_INDEX"))
+        return qEnvironmentVariable("ALBERT_APPLICATIONS_PREBUILT_INDEX");
+    return u"/var/cache/albert/applications.index"_s;
+}
+
+uint PrebuiltIndex::write(const QString &path,
+                          const map<QString, QString> &desktop_files,
+                          Application::ParseOptions po)
+{
+    const ExecutableIndex executables;
+    po.executables = &executables;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        throw runtime_error(file.errorString().toStdString());
+
+    QDataStream out(&file);
+    out.setVersion(stream_version);
+    out << magic << version << DesktopEntry::messagesLocale() << po.flags() << showInDesktops(po)
+        << quint32(desktop_files.size());
+
+    for (const auto &[id, desktop_file] : desktop_files)
+    {
+        QByteArray payload;
+        QDataStream p(&payload, QIODevice::WriteOnly);
+        p.setVersion(stream_version);
+
+        try
+        {
+            const Application app(id, desktop_file, po);
+            p << quint8(Parsed);
+            app.serialize(p);
+        }
+        catch (const exception &e)
+        {
+            p << quint8(Skipped) << QString::fromLocal8Bit(e.what());
+        }
+
+        // Checked again on load, the PATH of the build host may differ
+        const auto checks = executables.takeChecks();
+
+        const auto [mtime, size] = DesktopEntryIndexer::fileStamp(desktop_file);
+        out << desktop_file << mtime << size << quint32(checks.size());
+        for (const auto &[command, result] : checks)
+            out << command << result;
+        out << quint32(payload.size());
+        out.writeRawData(payload.constData(), payload.size());
+    }
+
+    if (out.status() != QDataStream::Ok || !file.commit())
+        throw runtime_error(file.errorString().toStdString());
+
+    return desktop_files.size();
+}
+
+PrebuiltIndex::PrebuiltIndex(const QString &path, const Application::ParseOptions &po)
+{
+    if (path.isEmpty() || !QFile::exists(path))
+        return;
+
+    auto file = make_unique<QFile>(path);
+    const uchar *data;
+    if (!file->open(QIODevice::ReadOnly) || !(data = file->map(0, file->size())))
+    {
+        WARN << "Failed to map prebuilt index:" << path << file->errorString();
+        return;
+    }
+
+    const auto bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(data), file->size());
+    QBuffer buffer;
+    buffer.setData(bytes);
+    buffer.open(QIODevice::ReadOnly);
+    QDataStream in(&buffer);
+    in.setVersion(stream_version);
+
+    quint32 m, v, count;
+    QString locale, desktops;
+    quint8 f;
+    in >> m >> v;
+
+    if (m != magic || v != version)
+    {
+        WARN << "Ignoring prebuilt index of another version:" << path;
+        return;
+    }
+
+    in >> locale >> f >> desktops >> count;
+    if (locale != DesktopEntry::messagesLocale() || f != po.flags() || desktops != showInDesktops(po))
+    {
+        DEBG << "Ignoring prebuilt index of another locale, desktop or other parse options:"
+             << path;
+        return;
+    }
+
+    entries_.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        QString desktop_file;
+        Entry e;
+        quint32 check_count;
+        in >> desktop_file >> e.mtime >> e.size >> check_count;
+        for (quint32 c = 0; c < check_count && in.status() == QDataStream::Ok; ++c)
+        {
+            auto &[command, result] = e.checks.emplace_back();
+            in >> command >> result;
+        }
+        in >> e.length;
+        e.offset = buffer.pos();
+        if (in.skipRawData(e.length) != int(e.length))
+            break;
+        entries_.insert(desktop_file, e);
+    }
+
+    if (in.status() != QDataStream::Ok || entries_.size() != count)
+    {
+        WARN << "Ignoring corrupt prebuilt index:" << path;
+        entries_.clear();
+        return;
+    }
+
+    file_ = ::move(file);
+    data_ = data;
+    DEBG << u"Mapped prebuilt index '%1' with %2 entries."_s.arg(path).arg(count);
+}
+
+PrebuiltIndex::~PrebuiltIndex() = default;
+
+bool PrebuiltIndex::isValid() const { return data_ != nullptr; }
+
+shared_ptr<Application> PrebuiltIndex::load(const QString &path,
+                                            pair<qint64, qint64> stamp,
+                                            const ExecutableIndex &executables,
+                                            size_t *hash) const
+{
+    auto it = entries_.constFind(path);
+    if (it == entries_.cend())
+        return {};
+
+    if (const auto [mtime, size] = stamp; mtime != it->mtime || size != it->size)
+        return {};
+
+    // Recorded like when parsing. Dropped if they differ, since the file is parsed then.
+    bool checks_hold = true;
+    for (const auto &[command, result] : it->checks)
+        checks_hold &= executables.contains(command) == result;
+    if (!checks_hold)
+    {
+        executables.takeChecks();
+        return {};
+    }
+
+    const auto payload = QByteArray::fromRawData(reinterpret_cast<const char*>(data_)
+                                                 + it->offset, it->length);
+    if (hash)
+        *hash = qHash(payload, 0);
+
+    QDataStream in(payload);
+    in.setVersion(stream_version);
+
+    quint8 status;
+    in >> status;
+    if (status == Skipped)
+    {
+        QString reason;
+        in >> reason;
+        throw runtime_error(reason.toStdString());
+    }
+
+    try {
+        return make_shared<Application>(in);
+    } catch (const runtime_error &e) {
+        WARN << u"Corrupt prebuilt index entry '%1':"_s.arg(path) << e.what();
+        return {};
+    }
+}
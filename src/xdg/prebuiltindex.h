@@ -0,0 +1,72 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include "application.h"
+#include "executableindex.h"
+#include <QHash>
+#include <QString>
+#include <map>
+#include <memory>
+class QFile;
+
+///
+/// Read-only, versioned index of parsed desktop entries.
+///
+/// Generated ahead of time for the system directories, e.g. at image build time or by a
+/// package manager trigger, and memory mapped at index time. An entry is used only if the
+/// modification time and size of its desktop file still match, otherwise the file is
+/// parsed. Desktop files not in the index, e.g. the user's, are parsed as well.
+///
+/// The index is valid only for the locale, parse options and, unless the show-in keys are
+/// ignored, XDG_CURRENT_DESKTOP it was written with. The TryExec and Exec checks made at
+/// write time are stored and checked again on load, since PATH of the host writing the
+/// index may differ.
+///
+class PrebuiltIndex
+{
+public:
+
+    /// Returns $ALBERT_APPLICATIONS_PREBUILT_INDEX if set, otherwise the default location.
+    /// An empty string disables the prebuilt index.
+    static QString defaultPath();
+
+    /// Parses _desktop_files_ (desktop id > path) using _po_ and writes the index to _path_
+    /// atomically. Returns the number of entries. Throws runtime_error on failure.
+    static uint write(const QString &path,
+                      const std::map<QString, QString> &desktop_files,
+                      Application::ParseOptions po);
+
+    /// Maps the index at _path_. The index is invalid if it does not exist or has been
+    /// written by another version, for another locale or desktop or using other parse
+    /// options.
+    PrebuiltIndex(const QString &path, const Application::ParseOptions &po);
+    ~PrebuiltIndex();
+
+    bool isValid() const;
+
+    /// Returns the application of the desktop file at _path_ or nullptr if the index has
+    /// no up-to-date entry for it. Throws runtime_error with the original reason if the
+    /// desktop entry has been skipped at write time. Up-to-dateness is checked by _stamp_,
+    /// see DesktopEntryIndexer::fileStamp(), and by the executable checks, which are made
+    /// using and recorded by _executables_. The desktop file is not accessed. Sets _hash_, if
+    /// not null, to a hash of the entry.
+    std::shared_ptr<Application> load(const QString &path, std::pair<qint64, qint64> stamp,
+                                      const ExecutableIndex &executables,
+                                      size_t *hash = nullptr) const;
+
+private:
+
+    struct Entry
+    {
+        qint64 mtime;
+        qint64 size;
+        qint64 offset;
+        quint32 length;
+        ExecutableIndex::Checks checks;
+    };
+
+    std::unique_ptr<QFile> file_;
+    const uchar *data_ = nullptr;
+    QHash<QString, Entry> entries_;  // Path > entry
+
+};
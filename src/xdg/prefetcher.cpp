@@ -0,0 +1,253 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "prefetcher.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QtConcurrentRun>
+#include <albert/logging.h>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <sys/syscall.h>
+#endif
+using namespace Qt::StringLiterals;
+using namespace std;
+
+static void setIdleIoPriority()
+{
+#if defined(Q_OS_LINUX)
+    // linux/ioprio.h is not available on all distributions
+    constexpr int ioprio_who_process = 1;
+    constexpr int ioprio_class_idle = 3;
+    constexpr int ioprio_class_shift = 13;
+    if (syscall(SYS_ioprio_set, ioprio_who_process, 0, ioprio_class_idle << ioprio_class_shift))
+        DEBG << "Failed to set idle I/O priority:" << strerror(errno);
+#endif
+}
+
+static const QStringList &libraryDirectories()
+{
+    static const QStringList dirs = []
+    {
+        QStringList candidates;
+
+        auto parse = [&](const QString &path)
+        {
+            if (QFile f(path); f.open(QIODevice::ReadOnly | QIODevice::Text))
+                while (!f.atEnd())
+                    if (auto line = QString::fromLocal8Bit(f.readLine()).trimmed();
+                        line.startsWith(u'/'))
+                        candidates << line;
+        };
+
+        parse(u"/etc/ld.so.conf"_s);
+        for (const auto &fi : QDir(u"/etc/ld.so.conf.d"_s).entryInfoList({u"*.conf"_s}, QDir::Files))
+            parse(fi.filePath());
+
+        candidates << u"/lib64"_s << u"/usr/lib64"_s << u"/lib"_s << u"/usr/lib"_s;
+
+        QStringList existing;
+        for (const auto &dir : as_const(candidates))
+            if (QFileInfo(dir).isDir() && !existing.contains(dir))
+                existing << dir;
+        return existing;
+    }();
+    return dirs;
+}
+
+template<class Ehdr, class Shdr, class Dyn>
+static void readDynamicSection(QFile &file, Prefetcher::DynamicSection &d)
+{
+    Ehdr ehdr;
+    if (!file.seek(0) || file.read(reinterpret_cast<char*>(&ehdr), sizeof ehdr) != sizeof ehdr
+        || ehdr.e_shentsize != sizeof(Shdr) || ehdr.e_shnum == 0)
+        return;
+
+    vector<Shdr> shdrs(ehdr.e_shnum);
+    const auto shdrs_size = static_cast<qint64>(shdrs.size() * sizeof(Shdr));
+    if (!file.seek(ehdr.e_shoff)
+        || file.read(reinterpret_cast<char*>(shdrs.data()), shdrs_size) != shdrs_size)
+        return;
+
+    auto readSection = [&](const Shdr &sh) -> QByteArray
+    {
+        static const decltype(sh.sh_size) max_section_size = 16 << 20;
+        if (sh.sh_size > max_section_size || !file.seek(sh.sh_offset))
+            return {};
+        return file.read(sh.sh_size);
+    };
+
+    for (const auto &sh : shdrs)
+    {
+        if (sh.sh_type != SHT_DYNAMIC || sh.sh_link >= shdrs.size())
+            continue;
+
+        const auto dynamic = readSection(sh);
+        const auto strings = readSection(shdrs[sh.sh_link]);  // NUL terminated by QByteArray
+        const auto *dyn = reinterpret_cast<const Dyn*>(dynamic.constData());
+        const auto count = static_cast<size_t>(dynamic.size()) / sizeof(Dyn);
+
+        for (size_t i = 0; i < count && dyn[i].d_tag != DT_NULL; ++i)
+            if (dyn[i].d_un.d_val < static_cast<decltype(dyn[i].d_un.d_val)>(strings.size()))
+            {
+                const auto value = QString::fromUtf8(strings.constData() + dyn[i].d_un.d_val);
+                if (dyn[i].d_tag == DT_NEEDED)
+                    d.needed << value;
+                else if (dyn[i].d_tag == DT_RPATH)
+                    d.rpath << value.split(u':', Qt::SkipEmptyParts);
+                else if (dyn[i].d_tag == DT_RUNPATH)
+                    d.runpath << value.split(u':', Qt::SkipEmptyParts);
+            }
+    }
+}
+
+Prefetcher::DynamicSection Prefetcher::dynamicSection(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    const auto ident = file.read(EI_NIDENT);
+    static const auto native_data = Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? ELFDATA2LSB : ELFDATA2MSB;
+    if (ident.size() != EI_NIDENT || !ident.startsWith(ELFMAG) || ident[EI_DATA] != native_data)
+        return {};  // Not an ELF file, e.g. a script, or foreign
+
+    DynamicSection d;
+    if (ident[EI_CLASS] == ELFCLASS64)
+        readDynamicSection<Elf64_Ehdr, Elf64_Shdr, Elf64_Dyn>(file, d);
+    else if (ident[EI_CLASS] == ELFCLASS32)
+        readDynamicSection<Elf32_Ehdr, Elf32_Shdr, Elf32_Dyn>(file, d);
+    return d;
+}
+
+QStringList Prefetcher::searchDirectories(const DynamicSection &dynamic, const QString &origin)
+{
+    auto expanded = [&](QStringList dirs)
+    {
+        for (auto &dir : dirs)
+            dir.replace(u"$ORIGIN"_s, origin).replace(u"${ORIGIN}"_s, origin);
+        return dirs;
+    };
+
+    QStringList dirs;
+    if (dynamic.runpath.isEmpty())
+        dirs << expanded(dynamic.rpath);
+    dirs << qEnvironmentVariable("LD_LIBRARY_PATH").split(u':', Qt::SkipEmptyParts);
+    dirs << expanded(dynamic.runpath);
+    dirs << libraryDirectories();
+    return dirs;
+}
+
+QStringList Prefetcher::sharedLibraries(const QString &path)
+{
+    const auto dynamic = dynamicSection(path);
+    if (dynamic.needed.isEmpty())
+        return {};
+
+    const auto search_dirs = searchDirectories(dynamic, QFileInfo(path).absolutePath());
+
+    QStringList libraries;
+    for (const auto &name : dynamic.needed)
+        if (name.contains(u'/'))
+            libraries << name;
+        else
+            for (const auto &dir : search_dirs)
+                if (auto lib = QDir(dir).filePath(name); QFile::exists(lib))
+                {
+                    libraries << lib;
+                    break;
+                }
+    return libraries;
+}
+
+static quint64 adviseWillNeed(const QString &path, quint64 max_bytes)
+{
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return 0;
+
+    quint64 bytes = 0;
+    if (struct stat st; fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+    {
+        bytes = min<quint64>(st.st_size, max_bytes);
+        if (posix_fadvise(fd, 0, static_cast<off_t>(bytes), POSIX_FADV_WILLNEED) != 0)
+            bytes = 0;
+    }
+
+    ::close(fd);
+    return bytes;
+}
+
+Prefetcher::Prefetcher()
+{
+    pool_.setMaxThreadCount(1);
+    pool_.setThreadPriority(QThread::IdlePriority);
+}
+
+Prefetcher::~Prefetcher()
+{
+    abort_ = true;
+    pool_.waitForDone();
+}
+
+void Prefetcher::prefetch(const QStringList &executables, quint64 byte_budget)
+{
+    if (!future_.isRunning())
+        future_ = QtConcurrent::run(&pool_, &Prefetcher::run, this, executables, byte_budget);
+}
+
+Prefetcher::Statistics Prefetcher::statistics() const
+{
+    lock_guard lock(mutex_);
+    return statistics_;
+}
+
+void Prefetcher::run(const QStringList &executables, quint64 byte_budget)
+{
+    setIdleIoPriority();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Breadth first, such that the executables come before their dependencies
+    deque<QString> queue(executables.begin(), executables.end());
+    QSet<QString> visited;
+    quint64 bytes = 0;
+    uint files = 0;
+
+    while (!queue.empty() && bytes < byte_budget && !abort_)
+    {
+        const auto path = QFileInfo(queue.front()).canonicalFilePath();
+        queue.pop_front();
+
+        if (path.isEmpty() || visited.contains(path))
+            continue;
+        visited.insert(path);
+
+        if (const auto advised = adviseWillNeed(path, byte_budget - bytes); advised > 0)
+        {
+            bytes += advised;
+            ++files;
+        }
+
+        for (const auto &lib : sharedLibraries(path))
+            queue.push_back(lib);
+    }
+
+    DEBG << u"Prefetched %1 files (%2 MiB) in %3 ms."_s
+                .arg(files).arg(bytes >> 20).arg(timer.elapsed());
+
+    lock_guard lock(mutex_);
+    ++statistics_.runs;
+    statistics_.files += files;
+    statistics_.bytes += bytes;
+    statistics_.duration_ms += timer.elapsed();
+}
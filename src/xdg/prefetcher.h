@@ -0,0 +1,69 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QFuture>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+#include <mutex>
+
+///
+/// Warms the page cache for executables and the shared libraries they link to.
+///
+/// Runs on a dedicated idle priority thread and uses idle I/O priority where available.
+///
+class Prefetcher
+{
+public:
+
+    struct Statistics
+    {
+        uint runs = 0;
+        uint files = 0;
+        quint64 bytes = 0;
+        qint64 duration_ms = 0;
+    };
+
+    Prefetcher();
+    ~Prefetcher();
+
+    /// Asynchronously advises the kernel to read _executables_ and their shared library
+    /// dependencies into the page cache. Stops after _byte_budget_ bytes have been advised.
+    /// Does nothing if a previous run is still in progress.
+    void prefetch(const QStringList &executables, quint64 byte_budget);
+
+    /// Returns the accumulated statistics of all runs.
+    Statistics statistics() const;
+
+    /// The dynamic section entries of an ELF file relevant to the library search.
+    struct DynamicSection
+    {
+        QStringList needed;  ///< DT_NEEDED
+        QStringList rpath;  ///< DT_RPATH, split
+        QStringList runpath;  ///< DT_RUNPATH, split
+    };
+
+    /// Returns the dynamic section of the ELF file at _path_. Empty if _path_ is not an ELF
+    /// file of the native byte order.
+    static DynamicSection dynamicSection(const QString &path);
+
+    /// Returns the directories searched for the dependencies of an object with the dynamic
+    /// section _dynamic_ in the directory _origin_, in the order of ld.so: DT_RPATH unless
+    /// DT_RUNPATH is present, LD_LIBRARY_PATH, DT_RUNPATH, ld.so.conf and the default
+    /// directories. The DT_RPATH of the loading executable is not inherited.
+    static QStringList searchDirectories(const DynamicSection &dynamic, const QString &origin);
+
+    /// Returns the resolved paths of the DT_NEEDED entries of the ELF file at _path_.
+    static QStringList sharedLibraries(const QString &path);
+
+private:
+
+    void run(const QStringList &executables, quint64 byte_budget);
+
+    QThreadPool pool_;
+    QFuture<void> future_;
+    std::atomic_bool abort_ = false;
+    mutable std::mutex mutex_;
+    Statistics statistics_;
+
+};
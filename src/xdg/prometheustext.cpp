@@ -0,0 +1,55 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "prometheustext.h"
+#include <QLocale>
+using namespace Qt::StringLiterals;
+using namespace std;
+
+void PrometheusText::family(const char *name, const char *type, const char *help)
+{
+    name_ = name;
+    text_ += "# HELP " + name_ + ' ' + help + '\n';
+    text_ += "# TYPE " + name_ + ' ' + type + '\n';
+}
+
+void PrometheusText::sample(const char *suffix, const Labels &labels, double value)
+{
+    text_ += name_ + suffix;
+    if (!labels.empty())
+    {
+        text_ += '{';
+        for (bool first = true; const auto &[label, label_value] : labels)
+        {
+            if (!first)
+                text_ += ',';
+            first = false;
+
+            auto escaped = label_value;
+            escaped.replace(u'\\', u"\\\\").replace(u'"', u"\\\"").replace(u'\n', u"\\n");
+            text_ += label + QByteArray("=\"") + escaped.toUtf8() + '"';
+        }
+        text_ += '}';
+    }
+    text_ += ' ' + number(value) + '\n';
+}
+
+void PrometheusText::histogram(const Labels &labels, const vector<double> &bounds,
+                            const vector<quint64> &counts, double sum)
+{
+    quint64 cumulative = 0;
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        cumulative += counts[i];
+        auto l = labels;
+        l.emplace_back("le", i < bounds.size() ? QString::fromLatin1(number(bounds[i]))
+                                               : u"+Inf"_s);
+        sample("_bucket", l, cumulative);
+    }
+    sample("_count", labels, cumulative);
+    sample("_sum", labels, sum);
+}
+
+QByteArray PrometheusText::text() const { return text_; }
+
+QByteArray PrometheusText::number(double value)
+{ return QByteArray::number(value, 'g', QLocale::FloatingPointShortest); }
@@ -0,0 +1,45 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#pragma once
+#include <QByteArray>
+#include <QString>
+#include <utility>
+#include <vector>
+
+///
+/// Writer of the Prometheus text exposition format (version 0.0.4).
+///
+/// The format parsed by the node_exporter textfile collector. Unlike in OpenMetrics, the
+/// family of a counter is named like its samples, i.e. including the '_total' suffix.
+///
+class PrometheusText
+{
+public:
+
+    using Labels = std::vector<std::pair<const char *, QString>>;
+
+    /// Starts the metric family _name_ of _type_, e.g. "counter", "gauge" or "histogram".
+    /// Names of counters end with '_total'.
+    void family(const char *name, const char *type, const char *help);
+
+    /// Adds a sample to the current family. _suffix_ is appended to the family name,
+    /// e.g. "_bucket" for histograms, usually it is empty.
+    void sample(const char *suffix, const Labels &labels, double value);
+
+    /// Adds the samples of a histogram to the current family. _bounds_ are the upper bounds
+    /// of the buckets, _counts_ the non-cumulative counts of the buckets and an overflow
+    /// bucket, i.e. it has one element more than _bounds_.
+    void histogram(const Labels &labels, const std::vector<double> &bounds,
+                   const std::vector<quint64> &counts, double sum);
+
+    /// Returns the exposition.
+    QByteArray text() const;
+
+private:
+
+    static QByteArray number(double value);
+
+    QByteArray name_;
+    QByteArray text_;
+
+};
@@ -1,5 +1,6 @@
 // Copyright (c) 2022-2024 Manuel Schneider
 
+#include "memoryreport.h"
 #include "terminal.h"
 #include <QMessageBox>
 #include <albert/logging.h>
@@ -9,6 +10,13 @@
 Terminal::Terminal(const ::Application &app, const QStringList &exec_arg):
     ::Application(app), exec_arg_(exec_arg) {}
 
+void Terminal::accountMemory(MemoryReport &r) const
+{
+    ::Application::accountMemory(r);
+    r.add(MemoryReport::Objects, sizeof(Terminal) - sizeof(::Application));
+    r.addStringList(exec_arg_);
+}
+
 void Terminal::launch(const QString &script) const
 {
     if (passwd *pwd = getpwuid(geteuid()); pwd == nullptr)
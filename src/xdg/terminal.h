@@ -15,6 +15,8 @@ public:
 
     using ::Application::launch;
 
+    void accountMemory(MemoryReport &) const override;
+
     void launch(const QString &script) const;
     void launch(QStringList commandline, const QString &working_dir = {}) const;
 
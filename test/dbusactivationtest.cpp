@@ -0,0 +1,112 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "dbusactivation.h"
+#include <QDBusConnection>
+#include <QDBusError>
+#include <QDBusPendingReply>
+#include <QTest>
+using namespace Qt::StringLiterals;
+
+static const auto service = u"org.albertlauncher.Applications-Test"_s;
+
+// Records the calls of org.freedesktop.Application
+class TestApplication : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.Application")
+
+public:
+
+    QString method;
+    QString action;
+    QVariantMap platform_data;
+
+public slots:
+
+    void Activate(const QVariantMap &data)
+    {
+        method = u"Activate"_s;
+        platform_data = data;
+    }
+
+    void ActivateAction(const QString &name, const QVariantList &, const QVariantMap &data)
+    {
+        method = u"ActivateAction"_s;
+        action = name;
+        platform_data = data;
+    }
+
+};
+
+class DBusActivationTest : public QObject
+{
+    Q_OBJECT
+
+    // A connection of its own, such that the calls are not delivered locally
+    QDBusConnection client = QDBusConnection::connectToBus(QDBusConnection::SessionBus,
+                                                           u"client"_s);
+    TestApplication application;
+
+private slots:
+
+    void initTestCase()
+    {
+        // Run by ctest in a private session bus using dbus-run-session
+        auto bus = QDBusConnection::sessionBus();
+        if (!bus.isConnected() || !client.isConnected())
+            QSKIP("No session bus.");
+
+        QVERIFY(bus.registerService(service));
+        QVERIFY(bus.registerObject(DBusActivation::objectPath(service), &application,
+                                   QDBusConnection::ExportAllSlots));
+    }
+
+    void cleanupTestCase()
+    {
+        QDBusConnection::sessionBus().unregisterService(service);
+        QDBusConnection::disconnectFromBus(u"client"_s);
+    }
+
+    void objectPath()
+    {
+        QCOMPARE(DBusActivation::objectPath(u"org.gnome.Nautilus"_s), u"/org/gnome/Nautilus"_s);
+        QCOMPARE(DBusActivation::objectPath(u"org.example.foo-bar"_s), u"/org/example/foo_bar"_s);
+    }
+
+    void activate()
+    {
+        QDBusPendingReply<> reply
+            = client.asyncCall(DBusActivation::message(service, {}, u"albert-1-test-1"_s));
+        QTRY_VERIFY(reply.isFinished());
+        QVERIFY2(!reply.isError(), qPrintable(reply.error().message()));
+        QCOMPARE(application.method, u"Activate"_s);
+        QCOMPARE(application.platform_data.value(u"desktop-startup-id"_s), u"albert-1-test-1"_s);
+
+        // xdg-activation tokens are issued by the compositor, not by the launcher
+        QVERIFY(!application.platform_data.contains(u"activation-token"_s));
+    }
+
+    void activateAction()
+    {
+        QDBusPendingReply<> reply = client.asyncCall(
+            DBusActivation::message(service, u"new-window"_s, u"albert-1-test-2"_s));
+        QTRY_VERIFY(reply.isFinished());
+        QVERIFY2(!reply.isError(), qPrintable(reply.error().message()));
+        QCOMPARE(application.method, u"ActivateAction"_s);
+        QCOMPARE(application.action, u"new-window"_s);
+        QCOMPARE(application.platform_data.value(u"desktop-startup-id"_s), u"albert-1-test-2"_s);
+    }
+
+    void unknownService()
+    {
+        // The error triggering the Exec fallback
+        QDBusPendingReply<> reply
+            = client.asyncCall(DBusActivation::message(service + u"-Missing"_s, {}, {}));
+        QTRY_VERIFY(reply.isFinished());
+        QVERIFY(reply.isError());
+    }
+
+};
+
+QTEST_GUILESS_MAIN(DBusActivationTest)
+#include "dbusactivationtest.moc"
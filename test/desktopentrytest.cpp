@@ -0,0 +1,190 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "desktopentry.h"
+#include <QFile>
+#include <QLocale>
+#include <QTemporaryDir>
+#include <QTest>
+#include <stdexcept>
+#include <sys/stat.h>
+using namespace Qt::StringLiterals;
+using namespace std;
+
+static const auto root = u"Desktop Entry"_s;
+
+class DesktopEntryTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void escapes()
+    {
+        const DesktopEntry e(R"([Desktop Entry]
+Name=a\sb\nc\td\re\\f
+Keywords=one\;two;three;
+Trailing=x\
+Unknown=\q
+)");
+        QCOMPARE(e.getString(root, u"Name"_s), u"a b\nc\td\re\\f"_s);
+
+        // Escaped semicolons are kept, such that lists can be split afterwards
+        QCOMPARE(e.getString(root, u"Keywords"_s), uR"(one\;two;three;)"_s);
+
+        QCOMPARE(e.getString(root, u"Trailing"_s), uR"(x\)"_s);
+        QCOMPARE(e.getString(root, u"Unknown"_s), uR"(\q)"_s);
+    }
+
+    void localeString_data()
+    {
+        QTest::addColumn<QString>("locale");
+        QTest::addColumn<QString>("name");
+
+        QTest::newRow("lang_COUNTRY@MODIFIER") << u"sr_RS@latin"_s << u"sr_RS@latin"_s;
+        QTest::newRow("encoding") << u"sr_RS.UTF-8@latin"_s << u"sr_RS@latin"_s;
+        QTest::newRow("lang_COUNTRY") << u"sr_RS"_s << u"sr_RS"_s;
+        QTest::newRow("lang@MODIFIER") << u"sr_ME@latin"_s << u"sr@latin"_s;
+        QTest::newRow("lang") << u"sr_BA"_s << u"sr"_s;
+        QTest::newRow("lang w/o country") << u"de"_s << u"de"_s;
+        QTest::newRow("lang of lang_COUNTRY") << u"de_AT.UTF-8"_s << u"de"_s;
+        QTest::newRow("unlocalized") << u"fr_FR"_s << u"default"_s;
+        QTest::newRow("C") << u"C"_s << u"default"_s;
+    }
+
+    void localeString()
+    {
+        QFETCH(QString, locale);
+        QFETCH(QString, name);
+
+        const DesktopEntry e(R"([Desktop Entry]
+Name=default
+Name[sr]=sr
+Name[sr@latin]=sr@latin
+Name[sr_RS]=sr_RS
+Name[sr_RS@latin]=sr_RS@latin
+Name[de]=de
+)");
+        QCOMPARE(e.getLocaleString(root, u"Name"_s, locale), name);
+    }
+
+    void localeStringFallsBackInOrder()
+    {
+        // lang_COUNTRY takes precedence over lang@MODIFIER
+        const DesktopEntry e("[Desktop Entry]\nName=default\nName[sr@latin]=a\nName[sr_RS]=b\n");
+        QCOMPARE(e.getLocaleString(root, u"Name"_s, u"sr_RS@latin"_s), u"b"_s);
+
+        // Localized values are unescaped as well
+        const DesktopEntry f("[Desktop Entry]\nName=default\nName[de]=a\\sb\n");
+        QCOMPARE(f.getLocaleString(root, u"Name"_s, u"de_DE"_s), u"a b"_s);
+
+        QVERIFY_THROWS_EXCEPTION(out_of_range, e.getLocaleString(root, u"Comment"_s, u"sr"_s));
+    }
+
+    void messagesLocale()
+    {
+        const auto lc_all = qgetenv("LC_ALL");
+        const auto default_locale = QLocale();
+
+        QLocale::setDefault(QLocale(u"sr_RS"_s));
+        qputenv("LC_ALL", "sr_RS.UTF-8@latin");
+        QCOMPARE(DesktopEntry::messagesLocale(), u"sr_RS@latin"_s);
+
+        // The modifier of another language does not apply
+        qputenv("LC_ALL", "de_DE.UTF-8@euro");
+        QCOMPARE(DesktopEntry::messagesLocale(), u"sr_RS"_s);
+
+        QLocale::setDefault(default_locale);
+        if (lc_all.isNull())
+            qunsetenv("LC_ALL");
+        else
+            qputenv("LC_ALL", lc_all);
+    }
+
+    void sections()
+    {
+        const DesktopEntry e(R"(Key=before any section
+[Desktop Entry]
+Name=App
+Actions=new;
+[Desktop Action new]
+Name=New Window
+[Desktop Entry]
+Name=Again
+Exec=app
+)");
+        QCOMPARE(e.getString(root, u"Name"_s), u"App"_s);
+        QCOMPARE(e.getString(u"Desktop Action new"_s, u"Name"_s), u"New Window"_s);
+
+        // Keys of reopened sections are merged, the first one wins
+        QCOMPARE(e.getString(root, u"Exec"_s), u"app"_s);
+
+        QVERIFY_THROWS_EXCEPTION(out_of_range, e.getString(root, u"Key"_s));
+        QVERIFY_THROWS_EXCEPTION(out_of_range, e.getString(u"Desktop Action new"_s, u"Exec"_s));
+        QVERIFY_THROWS_EXCEPTION(out_of_range, e.getString(u"Missing"_s, u"Name"_s));
+    }
+
+    void malformedLines()
+    {
+        const DesktopEntry e("[Desktop Entry]\r\n"
+                             "# Comment=no\r\n"
+                             "\r\n"
+                             "no separator\r\n"
+                             "=no key\r\n"
+                             "  Name  =  App  \r\n"
+                             "Exec=app --opt=value\r\n"
+                             "Empty=\r\n");
+        QCOMPARE(e.getString(root, u"Name"_s), u"App"_s);
+        QCOMPARE(e.getString(root, u"Exec"_s), u"app --opt=value"_s);
+        QCOMPARE(e.getString(root, u"Empty"_s), QString());
+        QVERIFY_THROWS_EXCEPTION(out_of_range, e.getString(root, u"# Comment"_s));
+        QVERIFY_THROWS_EXCEPTION(out_of_range, e.getString(root, u"no separator"_s));
+        QVERIFY_THROWS_EXCEPTION(out_of_range, e.getString(root, QString()));
+    }
+
+    void booleans()
+    {
+        const DesktopEntry e("[Desktop Entry]\nA=true\nB=1\nC=false\nD=0\nE=yes\n");
+        QVERIFY(e.getBoolean(root, u"A"_s));
+        QVERIFY(e.getBoolean(root, u"B"_s));
+        QVERIFY(!e.getBoolean(root, u"C"_s));
+        QVERIFY(!e.getBoolean(root, u"D"_s));
+        QVERIFY_THROWS_EXCEPTION(runtime_error, e.getBoolean(root, u"E"_s));
+        QVERIFY_THROWS_EXCEPTION(out_of_range, e.getBoolean(root, u"F"_s));
+    }
+
+    void read()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        const auto content = "[Desktop Entry]\nName=App\n"_ba;
+        QFile file(dir.filePath(u"app.desktop"_s));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(content), content.size());
+        file.close();
+
+        QCOMPARE(DesktopEntry::read(file.fileName()), content);
+        QCOMPARE(DesktopEntry::read(file.fileName(), content.size()), content);
+        QVERIFY_THROWS_EXCEPTION(runtime_error,
+                                 DesktopEntry::read(file.fileName(), content.size() - 1));
+    }
+
+    void readRejectsNonRegularFiles()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        QVERIFY_THROWS_EXCEPTION(runtime_error, DesktopEntry::read(dir.path()));
+        QVERIFY_THROWS_EXCEPTION(runtime_error, DesktopEntry::read(dir.filePath(u"missing"_s)));
+        QVERIFY_THROWS_EXCEPTION(runtime_error, DesktopEntry::read(u"/dev/null"_s));
+
+        // Must not block waiting for a writer
+        const auto fifo = dir.filePath(u"fifo.desktop"_s);
+        QCOMPARE(mkfifo(QFile::encodeName(fifo).constData(), 0600), 0);
+        QVERIFY_THROWS_EXCEPTION(runtime_error, DesktopEntry::read(fifo));
+    }
+
+};
+
+QTEST_GUILESS_MAIN(DesktopEntryTest)
+#include "desktopentrytest.moc"
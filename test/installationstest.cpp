@@ -0,0 +1,162 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "application.h"
+#include "installations.h"
+#include <QTest>
+using namespace Qt::StringLiterals;
+using namespace std;
+
+static shared_ptr<applications::Application> application(const QString &id, const QString &exec)
+{
+    const auto content = u"[Desktop Entry]\nType=Application\nName=%1\nExec=%2\n"_s.arg(id, exec);
+    return make_shared<Application>(id, u"/test/%1.desktop"_s.arg(id), content.toUtf8(),
+                                    Application::ParseOptions{
+                                        .hide_missing_executables = false,
+                                        .ignore_show_in_keys = true,
+                                        .use_exec = false,
+                                        .use_generic_name = false,
+                                        .use_keywords = false,
+                                        .use_non_localized_name = false,
+                                        .executables = nullptr
+                                    });
+}
+
+class InstallationsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void wrappedCommand_data()
+    {
+        QTest::addColumn<QStringList>("exec");
+        QTest::addColumn<QString>("command");
+        QTest::addColumn<QString>("program");
+        QTest::addColumn<QString>("source");
+        QTest::addColumn<bool>("guessed");
+
+        QTest::newRow("native")
+            << QStringList{u"firefox"_s, u"%u"_s}
+            << u"firefox"_s << u"firefox"_s << u"native"_s << false;
+
+        QTest::newRow("absolute path")
+            << QStringList{u"/usr/lib/firefox/firefox"_s}
+            << u"firefox"_s << u"/usr/lib/firefox/firefox"_s << u"native"_s << false;
+
+        QTest::newRow("env assignments")
+            << QStringList{u"env"_s, u"GDK_BACKEND=x11"_s, u"FOO=bar"_s, u"gimp"_s, u"%U"_s}
+            << u"gimp"_s << u"gimp"_s << u"native"_s << false;
+
+        QTest::newRow("env option with value")
+            << QStringList{u"/usr/bin/env"_s, u"-u"_s, u"QT_QPA_PLATFORM"_s, u"krita"_s}
+            << u"krita"_s << u"krita"_s << u"native"_s << false;
+
+        QTest::newRow("sh -c quoting")
+            << QStringList{u"sh"_s, u"-c"_s, uR"(exec "/opt/My App/app" --flag)"_s}
+            << u"app"_s << u"/opt/My App/app"_s << u"native"_s << false;
+
+        QTest::newRow("bash -c env")
+            << QStringList{u"bash"_s, u"-c"_s, u"env FOO=1 code --new-window"_s}
+            << u"code"_s << u"code"_s << u"native"_s << false;
+
+        QTest::newRow("flatpak --command")
+            << QStringList{u"/usr/bin/flatpak"_s, u"run"_s, u"--branch=stable"_s,
+                           u"--arch=x86_64"_s, u"--command=firefox"_s,
+                           u"org.mozilla.firefox"_s, u"@@u"_s, u"%u"_s, u"@@"_s}
+            << u"firefox"_s << u"/usr/bin/flatpak"_s << u"flatpak"_s << false;
+
+        QTest::newRow("flatpak w/o --command")
+            << QStringList{u"flatpak"_s, u"run"_s, u"org.gnome.Terminal"_s}
+            << u"terminal"_s << u"flatpak"_s << u"flatpak"_s << true;
+
+        QTest::newRow("snap")
+            << QStringList{u"/snap/bin/spotify"_s, u"%U"_s}
+            << u"spotify"_s << u"/snap/bin/spotify"_s << u"snap"_s << false;
+
+        QTest::newRow("snap in env")
+            << QStringList{u"env"_s, u"BAMF_DESKTOP_FILE_HINT=/var/lib/snapd/desktop/applications/code_code.desktop"_s,
+                           u"/snap/bin/code"_s, u"--force-user-env"_s}
+            << u"code"_s << u"/snap/bin/code"_s << u"snap"_s << false;
+
+        QTest::newRow("appimage version")
+            << QStringList{u"/home/user/Applications/Obsidian-1.5.3.AppImage"_s}
+            << u"obsidian"_s << u"/home/user/Applications/Obsidian-1.5.3.AppImage"_s
+            << u"appimage"_s << false;
+
+        QTest::newRow("appimage arch")
+            << QStringList{u"Foo_x86_64.AppImage"_s}
+            << u"foo"_s << u"Foo_x86_64.AppImage"_s << u"appimage"_s << false;
+
+        QTest::newRow("appimage version arch")
+            << QStringList{u"bar-v2.0-aarch64.appimage"_s}
+            << u"bar"_s << u"bar-v2.0-aarch64.appimage"_s << u"appimage"_s << false;
+    }
+
+    void wrappedCommand()
+    {
+        QFETCH(QStringList, exec);
+        QFETCH(QString, command);
+        QFETCH(QString, program);
+        QFETCH(QString, source);
+        QFETCH(bool, guessed);
+
+        const WrappedCommand w(exec);
+        QCOMPARE(w.command, command);
+        QCOMPARE(w.program, program);
+        QCOMPARE(Installations::name(w.source), source);
+        QCOMPARE(w.guessed, guessed);
+    }
+
+    void groupsByCommand()
+    {
+        const Installations i({application(u"firefox"_s, u"firefox %u"_s),
+                               application(u"org.mozilla.firefox"_s,
+                                           u"flatpak run --command=firefox org.mozilla.firefox"_s)},
+                              PackageSource::Native);
+        QCOMPARE(i.shadowedCount(), 1u);
+        QVERIFY(i.isShadowed(u"org.mozilla.firefox"_s));
+        QCOMPARE(i.alternatives(u"firefox"_s).size(), 1u);
+    }
+
+    void prefersTheSource()
+    {
+        const Installations i({application(u"firefox"_s, u"firefox %u"_s),
+                               application(u"org.mozilla.firefox"_s,
+                                           u"flatpak run --command=firefox org.mozilla.firefox"_s)},
+                              PackageSource::Flatpak);
+        QVERIFY(i.isShadowed(u"firefox"_s));
+        QVERIFY(!i.isShadowed(u"org.mozilla.firefox"_s));
+    }
+
+    void groupsGuessedCommandsOnMatchingIds()
+    {
+        const Installations i({application(u"org.gnome.Terminal"_s, u"gnome-terminal"_s),
+                               application(u"terminal-flatpak"_s,
+                                           u"flatpak run org.gnome.Terminal"_s)},
+                              PackageSource::Native);
+        QVERIFY(i.isShadowed(u"terminal-flatpak"_s));
+        QCOMPARE(i.alternatives(u"org.gnome.Terminal"_s).size(), 1u);
+    }
+
+    void doesNotGroupGuessedCommandsOtherwise()
+    {
+        // 'terminal' is guessed from the id, but is the command of another application
+        const Installations i({application(u"terminal"_s, u"terminal"_s),
+                               application(u"org.gnome.Terminal"_s,
+                                           u"flatpak run org.gnome.Terminal"_s)},
+                              PackageSource::Native);
+        QCOMPARE(i.shadowedCount(), 0u);
+    }
+
+    void doesNotGroupOneSource()
+    {
+        const Installations i({application(u"tool-a"_s, u"python3 /opt/a.py"_s),
+                               application(u"tool-b"_s, u"python3 /opt/b.py"_s)},
+                              PackageSource::Native);
+        QCOMPARE(i.shadowedCount(), 0u);
+    }
+
+};
+
+QTEST_GUILESS_MAIN(InstallationsTest)
+#include "installationstest.moc"
@@ -0,0 +1,81 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "launcher.h"
+#include "launchprofile.h"
+#include <QFile>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QTest>
+using namespace Qt::StringLiterals;
+using namespace std;
+
+// Returns the nice value of the process whose /proc/<pid>/stat is _stat_, or nullopt.
+static optional<int> niceOfStat(const QByteArray &stat)
+{
+    // The command name may contain spaces, the fields after it start with the third, state
+    const auto fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+    bool ok = false;
+    const auto nice = fields.size() > 16 ? fields[16].toInt(&ok) : 0;  // Field 19
+    return ok ? optional(nice) : nullopt;
+}
+
+class LauncherTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void appliesTheLaunchProfile()
+    {
+#if QT_VERSION < QT_VERSION_CHECK(6, 6, 0)
+        QSKIP("Launch profiles require Qt 6.6.");
+#endif
+        QFile self(u"/proc/self/stat"_s);
+        if (!self.open(QIODevice::ReadOnly))
+            QSKIP("No procfs.");
+
+        // Raising the nice level does not require privileges
+        const auto own_nice = niceOfStat(self.readAll());
+        QVERIFY(own_nice);
+        QVERIFY2(*own_nice < 19, "The test process already runs at the lowest priority.");
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        QSettings settings(dir.filePath(u"settings.ini"_s), QSettings::IniFormat);
+        settings.setValue("launch_profiles/test/match", u"org.albertlauncher.test"_s);
+        settings.setValue("launch_profiles/test/nice", 19);
+        const auto profiles = LaunchProfile::load(settings);
+        const auto profile = LaunchProfile::match(profiles, u"org.albertlauncher.test"_s, {});
+        QVERIFY(profile);
+
+        const auto output = dir.filePath(u"stat"_s);
+        Launcher::Launch launch{
+            .id = u"org.albertlauncher.test"_s,
+            .commandline = {u"/bin/sh"_s, u"-c"_s, u"cat /proc/self/stat > '%1'"_s.arg(output)},
+            .working_dir = dir.path(),
+            .environment = {},
+            .startup_id = {},
+            .activated = {},
+            .profile = profile
+        };
+
+        Launcher launcher;
+        QVERIFY(launcher.submit(::move(launch)));
+
+        QByteArray stat;
+        auto written = [&]
+        {
+            if (QFile f(output); f.open(QIODevice::ReadOnly))
+                stat = f.readAll();
+            return stat.endsWith('\n');
+        };
+        QTRY_VERIFY_WITH_TIMEOUT(written(), 10000);
+
+        QCOMPARE(niceOfStat(stat), optional(19));
+    }
+
+};
+
+QTEST_GUILESS_MAIN(LauncherTest)
+#include "launchertest.moc"
@@ -0,0 +1,96 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "prefetcher.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QTest>
+#include <algorithm>
+using namespace Qt::StringLiterals;
+using namespace std;
+
+// Returns the path of the mapped library with the file name _name_, if any.
+static QString mappedLibrary(const QString &name)
+{
+    QFile maps(u"/proc/self/maps"_s);
+    if (!maps.open(QIODevice::ReadOnly | QIODevice::Text))
+        return {};
+
+    while (!maps.atEnd())
+        if (const auto line = QString::fromLocal8Bit(maps.readLine()).trimmed();
+            line.endsWith(u'/' + name))
+            return line.section(QChar::Space, -1);
+    return {};
+}
+
+class PrefetcherTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void dynamicSectionOfThisExecutable()
+    {
+        const auto d = Prefetcher::dynamicSection(QCoreApplication::applicationFilePath());
+        QVERIFY(ranges::any_of(d.needed, [](const auto &n){ return n.startsWith(u"libQt6Test.so"_s); }));
+        QVERIFY(ranges::any_of(d.needed, [](const auto &n){ return n.startsWith(u"libQt6Core.so"_s); }));
+    }
+
+    void notAnElfFile()
+    {
+        QVERIFY(Prefetcher::dynamicSection(u"/etc/passwd"_s).needed.isEmpty());
+        QVERIFY(Prefetcher::dynamicSection(u"/nonexistent"_s).needed.isEmpty());
+        QVERIFY(Prefetcher::sharedLibraries(u"/etc/passwd"_s).isEmpty());
+    }
+
+    void resolvesTheLoadedLibraries()
+    {
+        // Resolved like ld.so did when starting this test. System libraries may have been
+        // loaded from glibc-hwcaps subdirectories, which are not searched.
+        const auto path = QCoreApplication::applicationFilePath();
+        const auto needed = Prefetcher::dynamicSection(path).needed;
+        const auto libraries = Prefetcher::sharedLibraries(path);
+        QVERIFY(!libraries.isEmpty());
+
+        for (const auto &lib : libraries)
+        {
+            const auto name = QFileInfo(lib).fileName();
+            QVERIFY2(needed.contains(name), qPrintable(lib));
+            if (const auto mapped = mappedLibrary(name);
+                name.startsWith(u"libQt6"_s) && !mapped.isEmpty())
+                QCOMPARE(QFileInfo(lib).canonicalFilePath(), QFileInfo(mapped).canonicalFilePath());
+        }
+    }
+
+    void searchOrder()
+    {
+        const auto ld_library_path = qgetenv("LD_LIBRARY_PATH");
+        qputenv("LD_LIBRARY_PATH", "/env1::/env2");
+
+        Prefetcher::DynamicSection d{
+            .needed = {},
+            .rpath = {u"/rpath"_s},
+            .runpath = {u"$ORIGIN/../lib"_s, u"${ORIGIN}/lib"_s}
+        };
+
+        // DT_RPATH is ignored in the presence of DT_RUNPATH, which comes after LD_LIBRARY_PATH
+        auto dirs = Prefetcher::searchDirectories(d, u"/opt/app/bin"_s);
+        QCOMPARE(dirs.mid(0, 4), QStringList({u"/env1"_s, u"/env2"_s,
+                                              u"/opt/app/bin/../lib"_s, u"/opt/app/bin/lib"_s}));
+        QVERIFY(!dirs.contains(u"/rpath"_s));
+
+        // DT_RPATH comes before LD_LIBRARY_PATH
+        d.runpath.clear();
+        dirs = Prefetcher::searchDirectories(d, u"/opt/app/bin"_s);
+        QCOMPARE(dirs.mid(0, 3), QStringList({u"/rpath"_s, u"/env1"_s, u"/env2"_s}));
+
+        if (ld_library_path.isNull())
+            qunsetenv("LD_LIBRARY_PATH");
+        else
+            qputenv("LD_LIBRARY_PATH", ld_library_path);
+    }
+
+};
+
+QTEST_GUILESS_MAIN(PrefetcherTest)
+#include "prefetchertest.moc"
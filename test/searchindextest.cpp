@@ -0,0 +1,110 @@
+// Copyright (c) 2026 Manuel Schneider
+
+#include "searchindex.h"
+#include <QTest>
+#include <albert/icon.h>
+#include <albert/item.h>
+#include <algorithm>
+using namespace Qt::StringLiterals;
+using namespace albert;
+using namespace std;
+
+class TestItem : public Item
+{
+public:
+    explicit TestItem(const QString &text) : text_(text) {}
+    QString id() const override { return text_; }
+    QString text() const override { return text_; }
+    QString subtext() const override { return {}; }
+    unique_ptr<Icon> icon() const override { return {}; }
+private:
+    const QString text_;
+};
+
+static SearchIndex makeIndex(const QStringList &names, const map<QString, uint> &launch_counts = {})
+{
+    vector<IndexItem> items;
+    for (const auto &name : names)
+        items.emplace_back(make_shared<TestItem>(name), name);
+    return SearchIndex(::move(items), launch_counts);
+}
+
+static QStringList search(const SearchIndex &index, const QString &query)
+{
+    QStringList ids;
+    for (const auto &rank_item : index.search(query))
+        ids << rank_item.item->id();
+    ids.sort();
+    return ids;
+}
+
+// Ordered by descending score
+static QStringList ranked(const SearchIndex &index, const QString &query)
+{
+    auto results = index.search(query);
+    ranges::sort(results, [](const auto &a, const auto &b){ return a.score > b.score; });
+
+    QStringList ids;
+    for (const auto &rank_item : results)
+        ids << rank_item.item->id();
+    return ids;
+}
+
+class SearchIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void prefix()
+    {
+        const auto index = makeIndex({u"Google Chrome"_s, u"Chromium"_s, u"Firefox"_s});
+        QCOMPARE(search(index, u"chr"_s), QStringList({u"Chromium"_s, u"Google Chrome"_s}));
+    }
+
+    void midWordTransposition()
+    {
+        const auto index = makeIndex({u"Google Chrome"_s, u"Firefox"_s, u"Thunderbird"_s});
+        QCOMPARE(search(index, u"chorme"_s), QStringList{u"Google Chrome"_s});
+        QCOMPARE(search(index, u"firefxo"_s), QStringList{u"Firefox"_s});
+        QCOMPARE(search(index, u"thudnerbird"_s), QStringList{u"Thunderbird"_s});
+    }
+
+    void emptyQuery()
+    {
+        const auto index = makeIndex({u"Google Chrome"_s, u"Firefox"_s}, {{u"Firefox"_s, 3}});
+        QVERIFY(search(index, {}).isEmpty());
+        QVERIFY(search(index, u" "_s).isEmpty());
+        QVERIFY(search(index, u" - . "_s).isEmpty());
+    }
+
+    void acronym()
+    {
+        const auto index = makeIndex({u"Visual Studio Code"_s, u"LibreOffice Writer"_s,
+                                      u"Vim"_s});
+        QCOMPARE(search(index, u"vsc"_s), QStringList{u"Visual Studio Code"_s});
+        QCOMPARE(search(index, u"low"_s), QStringList{u"LibreOffice Writer"_s});
+
+        // Medial capitals split words
+        QCOMPARE(search(index, u"office"_s), QStringList{u"LibreOffice Writer"_s});
+
+        // Full matches rank above acronym matches
+        const auto vim = makeIndex({u"Vim"_s, u"Visual Image Manager"_s});
+        QCOMPARE(ranked(vim, u"vim"_s),
+                 QStringList({u"Vim"_s, u"Visual Image Manager"_s}));
+    }
+
+    void frequencyRanking()
+    {
+        // Equal match scores, the launch frequency decides
+        const QStringList names{u"Kate"_s, u"Kite"_s};
+        QCOMPARE(ranked(makeIndex(names, {{u"Kite"_s, 10}}), u"k"_s),
+                 QStringList({u"Kite"_s, u"Kate"_s}));
+        QCOMPARE(ranked(makeIndex(names, {{u"Kate"_s, 10}, {u"Kite"_s, 1}}), u"k"_s),
+                 QStringList({u"Kate"_s, u"Kite"_s}));
+    }
+
+};
+
+QTEST_APPLESS_MAIN(SearchIndexTest)
+#include "searchindextest.moc"